@@ -2,7 +2,7 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -11,21 +11,28 @@ CONFIG += c++11
 SOURCES += \
     BuildingSetup.cpp \
     LogConsole.cpp \
+    LogFilterSetup.cpp \
+    LogModel.cpp \
     PassengerBehaviourSetup.cpp \
     SafetyEventSetup.cpp \
     SimulationControls.cpp \
+    SimulationWorker.cpp \
     main.cpp \
     mainwindow.cpp
 
 HEADERS += \
     BuildingSetup.h \
     LogConsole.h \
-    PassengerAction.h \
+    LogFilterSetup.h \
+    LogModel.h \
     PassengerBehaviourSetup.h \
     SafetyEventSetup.h \
     SimulationControls.h \
+    SimulationWorker.h \
     mainwindow.h
 
+include(engine/engine.pri)
+
 FORMS += \
     mainwindow.ui
 
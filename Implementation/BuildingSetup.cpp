@@ -28,16 +28,27 @@ int BuildingSetup::getElevatorCount() const
     return elevatorsInput ? elevatorsInput->text().toInt() : 0;
 }
 
-void BuildingSetup::logBuildingParameters() const
+void BuildingSetup::setParameters(int passengerCount, int floorCount, int elevatorCount)
 {
-    if (logConsole) {
-        QString message = QString("Building Setup:\n"
-                                 "> Passengers: %1\n"
-                                 "> Floors: %2\n"
-                                 "> Elevators: %3")
-                         .arg(getPassengerCount())
-                         .arg(getFloorCount())
-                         .arg(getElevatorCount());
-        logConsole->logMessage(message);
+    if (passengersInput) {
+        passengersInput->setText(QString::number(passengerCount));
+    }
+    if (floorsInput) {
+        floorsInput->setText(QString::number(floorCount));
     }
+    if (elevatorsInput) {
+        elevatorsInput->setText(QString::number(elevatorCount));
+    }
+}
+
+void BuildingSetup::logBuildingParameters() const
+{
+    LOG_CONSOLE(logConsole, Lifecycle, Info,
+                QString("Building Setup:\n"
+                        "> Passengers: %1\n"
+                        "> Floors: %2\n"
+                        "> Elevators: %3")
+                .arg(getPassengerCount())
+                .arg(getFloorCount())
+                .arg(getElevatorCount()));
 }
@@ -28,6 +28,9 @@ public:
     int getFloorCount() const;
     int getElevatorCount() const;
 
+    // Fills the inputs, e.g. from a loaded scenario
+    void setParameters(int passengerCount, int floorCount, int elevatorCount);
+
     // Displays building setup on log console
     void logBuildingParameters() const;
 
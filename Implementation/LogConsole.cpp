@@ -1,13 +1,259 @@
 #include "LogConsole.h"
+#include "Profiler.h"
+#include <QScrollBar>
 
-LogConsole::LogConsole(QTextEdit *logOutput, QObject *parent)
-    : QObject(parent), logOutput(logOutput)
+namespace {
+
+const int ringCapacity = 4096;
+const int frameIntervalMs = 16;
+
+}
+
+LogConsole::LogConsole(QListView *logView,
+                       QComboBox *categoryFilter,
+                       QLineEdit *carFilter,
+                       QLineEdit *passengerFilter,
+                       QObject *parent)
+    : QObject(parent),
+      logView(logView),
+      categoryFilter(categoryFilter),
+      carFilter(carFilter),
+      passengerFilter(passengerFilter),
+      logFile(nullptr),
+      ringBuffer(ringCapacity),
+      ringHead(0),
+      ringCount(0),
+      flushBatchSize(1024),
+      maxFlushRate(30),
+      lastFlushLineCount(0),
+      lastFlushDurationNs(0)
+{
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    connect(flushTimer, &QTimer::timeout, this, &LogConsole::flush);
+    sinceLastFlush.start();
+
+    model = new LogModel(LogModel::defaultCapacity, this);
+    if (logView) {
+        // Uniform rows let the view lay out only the visible lines instead of measuring every one
+        logView->setUniformItemSizes(true);
+        logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        logView->setModel(model);
+    }
+
+    if (categoryFilter) {
+        categoryFilter->addItem("All categories", -1);
+        for (int category = 0; category < SimulationLog::CategoryCount; ++category) {
+            categoryFilter->addItem(SimulationLog::categoryName(static_cast<SimulationLog::Category>(category)),
+                                    category);
+        }
+        connect(categoryFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &LogConsole::applyQuery);
+    }
+    if (carFilter) {
+        carFilter->setPlaceholderText("Car ID");
+        connect(carFilter, &QLineEdit::textChanged, this, &LogConsole::applyQuery);
+    }
+    if (passengerFilter) {
+        passengerFilter->setPlaceholderText("Passenger ID");
+        connect(passengerFilter, &QLineEdit::textChanged, this, &LogConsole::applyQuery);
+    }
+}
+
+/**
+ * @brief Buffers a message, the model is only touched when the buffer is flushed. A message of several lines,
+ *        such as a setup summary, takes one row per line since the view's rows are one line high
+ * @param message The line to display
+ * @param category The part of the simulation the message is about
+ * @param level The message's severity
+ * @param subject The car and the passenger the message is about, the filter inputs match on them
+ */
+void LogConsole::logMessage(const QString &message, SimulationLog::Category category, SimulationLog::Level level,
+                            const SimulationLog::Subject &subject)
+{
+    PROFILE_SCOPE("LogConsole::logMessage");
+
+    const bool toFile = logFile && fileFilter.isEnabled(category, level);
+    const bool toView = logView && logFilter.isEnabled(category, level);
+    if (!toFile && !toView) {
+        return;
+    }
+
+    if (message.contains('\n')) {
+        for (const QString &part : message.split('\n')) {
+            logMessage(part, category, level, subject);
+        }
+        return;
+    }
+
+    if (toFile) {
+        // Only queued, the file is written on the writer's own thread
+        logFile->write(category, level, message.toStdString());
+    }
+    if (!toView) {
+        return;
+    }
+
+    LogModel::Line &line = nextLine();
+    line.text = message;
+    line.category = category;
+    line.level = level;
+    line.subject = subject;
+    line.isTrip = false;
+    lineAdded();
+}
+
+/**
+ * @brief Buffers a trip as a single line, LogModel builds the per-floor text when the view asks for it
+ * @param trip The car's trip to its next stop
+ */
+void LogConsole::logTrip(const MovementSegment &trip)
+{
+    if (logFile && fileFilter.isEnabled(SimulationLog::Movement, SimulationLog::Debug)) {
+        // The file has no rows to expand later, it gets every floor like the command line output
+        for (int floors = 1; floors <= trip.floorCount(); ++floors) {
+            logFile->write(SimulationLog::Movement, SimulationLog::Debug, trip.floorMessage(floors));
+        }
+    }
+    if (!logView || !logFilter.isEnabled(SimulationLog::Movement, SimulationLog::Debug)) {
+        return;
+    }
+
+    LogModel::Line &line = nextLine();
+    line.category = SimulationLog::Movement;
+    line.level = SimulationLog::Debug;
+    line.subject = SimulationLog::car(trip.carId);
+    line.isTrip = true;
+    line.trip = trip;
+    lineAdded();
+}
+
+/**
+ * @brief Appends the buffered messages to the model as a single row insertion. A view scrolled to the bottom
+ *        follows the new lines, one scrolled up stays where it is
+ */
+void LogConsole::flush()
+{
+    PROFILE_SCOPE("LogConsole::flush");
+
+    flushTimer->stop();
+    if (!logView || ringCount == 0) {
+        return;
+    }
+
+    QElapsedTimer flushTime;
+    flushTime.start();
+
+    QVector<LogModel::Line> lines;
+    lines.reserve(ringCount);
+    for (int i = 0; i < ringCount; ++i) {
+        LogModel::Line &line = ringBuffer[(ringHead + i) % ringCapacity];
+        lines.append(line);
+        line.text.clear();
+    }
+
+    QScrollBar *scrollBar = logView->verticalScrollBar();
+    const bool followLatest = scrollBar->value() == scrollBar->maximum();
+    model->append(lines);
+    if (followLatest) {
+        logView->scrollToBottom();
+    }
+
+    lastFlushLineCount = ringCount;
+    lastFlushDurationNs = flushTime.nsecsElapsed();
+    ringHead = (ringHead + ringCount) % ringCapacity;
+    ringCount = 0;
+    sinceLastFlush.restart();
+
+    emit flushed(lastFlushLineCount, lastFlushDurationNs);
+}
+
+LogModel::Line &LogConsole::nextLine()
 {
+    // A full ring is flushed right away so no message is ever overwritten
+    if (ringCount == ringCapacity) {
+        flush();
+    }
+    ++ringCount;
+    return ringBuffer[(ringHead + ringCount - 1) % ringCapacity];
+}
+
+void LogConsole::lineAdded()
+{
+    if (ringCount >= flushBatchSize && sinceLastFlush.elapsed() >= minFlushIntervalMs()) {
+        flush();
+    } else {
+        scheduleFlush();
+    }
 }
 
-void LogConsole::logMessage(const QString &message)
+void LogConsole::setLogFilter(const LogFilter &filter)
 {
-    if (logOutput) {
-        logOutput->append(message);
+    logFilter = filter;
+    updateEngineFilter();
+}
+
+void LogConsole::setLogFile(LogFileWriter *logFile, const LogFilter &fileFilter)
+{
+    this->logFile = logFile;
+    this->fileFilter = fileFilter;
+    updateEngineFilter();
+}
+
+void LogConsole::updateEngineFilter()
+{
+    engineFilter = logFilter;
+    if (logFile) {
+        engineFilter.enable(fileFilter);
+    }
+    emit logFilterChanged(engineFilter);
+}
+
+void LogConsole::setFlushBatchSize(int messages)
+{
+    flushBatchSize = qBound(1, messages, ringCapacity);
+}
+
+void LogConsole::setMaxFlushRate(int flushesPerSecond)
+{
+    maxFlushRate = qMax(0, flushesPerSecond);
+}
+
+int LogConsole::minFlushIntervalMs() const
+{
+    return maxFlushRate > 0 ? 1000 / maxFlushRate : 0;
+}
+
+void LogConsole::scheduleFlush()
+{
+    if (flushTimer->isActive()) {
+        return;
+    }
+
+    // Next frame, or later if the previous flush was too recent for the max flush rate
+    qint64 wait = qMax<qint64>(frameIntervalMs, minFlushIntervalMs() - sinceLastFlush.elapsed());
+    flushTimer->start(static_cast<int>(wait));
+}
+
+/**
+ * @brief An empty or invalid car or passenger ID matches every line
+ */
+void LogConsole::applyQuery()
+{
+    LogModel::Query query;
+    if (categoryFilter) {
+        query.category = categoryFilter->currentData().toInt();
+    }
+    bool valid = false;
+    if (carFilter) {
+        int carId = carFilter->text().trimmed().toInt(&valid);
+        query.carId = valid && carId >= 0 ? carId : -1;
+    }
+    if (passengerFilter) {
+        int passengerId = passengerFilter->text().trimmed().toInt(&valid);
+        query.passengerId = valid && passengerId >= 0 ? passengerId : -1;
+    }
+    model->setQuery(query);
+    if (logView) {
+        logView->scrollToBottom();
     }
 }
@@ -2,9 +2,24 @@
 #define LOGCONSOLE_H
 
 #include <QObject>
-#include <QTextEdit>
+#include <QListView>
+#include <QComboBox>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QTimer>
+#include <QVector>
+#include <QElapsedTimer>
+#include "LogFileWriter.h"
+#include "LogModel.h"
+#include "SimulationLog.h"
+
+// Builds message (and runs its QString::arg calls) only when the console would display it or write it to its log file
+#define LOG_CONSOLE(console, category, level, message) \
+    do { \
+        if ((console) && (console)->isEnabled(SimulationLog::category, SimulationLog::level)) { \
+            (console)->logMessage((message), SimulationLog::category, SimulationLog::level); \
+        } \
+    } while (0)
 
 /**
  * @brief The LogConsole class is responsible for logging:
@@ -13,17 +28,108 @@
  *        - The handling of safety events
  *        - System responses
  *        - The running state of the simulation
+ *        Every message has a category and a severity level, disabled ones are dropped before formatting.
+ *        Messages are buffered in a ring buffer and appended to the LogModel in one batch,
+ *        once per frame or every flushBatchSize messages, so the view updates once per batch.
+ *        The model keeps the latest LogModel::defaultCapacity lines and the list view only draws the visible
+ *        ones. The optional filter inputs narrow the view to a category, a car and a passenger.
+ *        A log file has its own filter: a line it lets through is queued to the file whether the console shows it
+ *        or not, the engine's lines as well as the ones logged here directly, such as the start and stop messages
+ *        and the setup summaries. The engine is given both filters at once, so it formats what either needs
  */
 class LogConsole : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit LogConsole(QTextEdit *logOutput, QObject *parent = nullptr);
-    void logMessage(const QString &message);
+    explicit LogConsole(QListView *logView,
+                        QComboBox *categoryFilter = nullptr,
+                        QLineEdit *carFilter = nullptr,
+                        QLineEdit *passengerFilter = nullptr,
+                        QObject *parent = nullptr);
+    void logMessage(const QString &message,
+                    SimulationLog::Category category = SimulationLog::Lifecycle,
+                    SimulationLog::Level level = SimulationLog::Info,
+                    const SimulationLog::Subject &subject = SimulationLog::Subject());
+    // Logs a car's trip as one Movement Debug line, its floors are only written out when the line is shown
+    void logTrip(const MovementSegment &trip);
+
+    // True if messages of this category and level are displayed or written to the log file
+    bool isEnabled(SimulationLog::Category category, SimulationLog::Level level) const {
+        return engineFilter.isEnabled(category, level);
+    }
+
+    // Minimum level per category of the displayed messages
+    void setLogFilter(const LogFilter &filter);
+    const LogFilter &getLogFilter() const { return logFilter; }
+    // What the console displays plus what the log file keeps, for the engine to skip formatting the rest
+    const LogFilter &getEngineFilter() const { return engineFilter; }
+
+    // Appends every buffered message to the model now
+    void flush();
+
+    // Buffered messages that trigger a flush without waiting for the next frame
+    void setFlushBatchSize(int messages);
+    int getFlushBatchSize() const { return flushBatchSize; }
+
+    // Upper bound on flushes per second, 0 for no limit (flushes then only wait for the next frame or batch)
+    void setMaxFlushRate(int flushesPerSecond);
+    int getMaxFlushRate() const { return maxFlushRate; }
+
+    // Messages waiting for the next flush, a producer can yield to the event loop before the ring fills up
+    int getBufferedCount() const { return ringCount; }
+    int getBufferCapacity() const { return ringBuffer.size(); }
+
+    LogModel *getModel() const { return model; }
+
+    // Also queues the lines fileFilter lets through to logFile, displayed or not, nullptr for none. The writer
+    // must outlive the console
+    void setLogFile(LogFileWriter *logFile, const LogFilter &fileFilter = LogFilter());
+
+    // Statistics of the most recent flush
+    int getLastFlushLineCount() const { return lastFlushLineCount; }
+    qint64 getLastFlushDurationNs() const { return lastFlushDurationNs; }
+
+signals:
+    // Emitted with the new engine filter when the console's or the log file's filter changes, so the running
+    // engine can apply it
+    void logFilterChanged(const LogFilter &filter);
+
+    // Emitted after each flush with the number of lines written and the time spent in the model and view
+    void flushed(int lineCount, qint64 durationNs);
 
 private:
-    QTextEdit *logOutput;
+    // Takes the next free line of the ring, flushing a full ring first
+    LogModel::Line &nextLine();
+    // Flushes a full batch, or schedules the next flush
+    void lineAdded();
+    // Starts the flush timer for the earliest flush the max flush rate allows
+    void scheduleFlush();
+    int minFlushIntervalMs() const;
+    // Reads the filter inputs into the model's query
+    void applyQuery();
+    void updateEngineFilter();
+
+    QListView *logView;
+    QComboBox *categoryFilter;
+    QLineEdit *carFilter;
+    QLineEdit *passengerFilter;
+    LogModel *model;
+    LogFilter logFilter;
+    LogFileWriter *logFile;
+    LogFilter fileFilter;
+    LogFilter engineFilter;      // logFilter plus fileFilter while a log file is set
+
+    QVector<LogModel::Line> ringBuffer; // Fixed capacity, a full buffer is flushed before it would overwrite a message
+    int ringHead;                // Index of the oldest buffered message
+    int ringCount;               // Number of buffered messages
+
+    QTimer *flushTimer;
+    QElapsedTimer sinceLastFlush;
+    int flushBatchSize;
+    int maxFlushRate;
+    int lastFlushLineCount;
+    qint64 lastFlushDurationNs;
 };
 
 #endif // LOGCONSOLE_H
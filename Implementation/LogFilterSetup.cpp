@@ -0,0 +1,52 @@
+#include "LogFilterSetup.h"
+
+LogFilterSetup::LogFilterSetup(QComboBox *levelInput,
+                               QCheckBox *movementCheck,
+                               QCheckBox *passengerCheck,
+                               QCheckBox *safetyCheck,
+                               QCheckBox *lifecycleCheck,
+                               LogConsole *logConsole,
+                               QObject *parent)
+    : QObject(parent),
+      levelInput(levelInput),
+      categoryChecks{movementCheck, passengerCheck, safetyCheck, lifecycleCheck},
+      logConsole(logConsole)
+{
+    if (levelInput) {
+        for (int level = SimulationLog::Debug; level <= SimulationLog::Critical; ++level) {
+            levelInput->addItem(SimulationLog::levelName(static_cast<SimulationLog::Level>(level)), level);
+        }
+        levelInput->setCurrentIndex(SimulationLog::Debug);
+        connect(levelInput, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                this, &LogFilterSetup::onFilterChanged);
+    }
+    for (QCheckBox *check : categoryChecks) {
+        if (check) {
+            connect(check, &QCheckBox::toggled, this, &LogFilterSetup::onFilterChanged);
+        }
+    }
+
+    onFilterChanged();
+}
+
+/**
+ * @brief Applies the level to every checked category and disables the others
+ */
+void LogFilterSetup::onFilterChanged()
+{
+    if (!logConsole) {
+        return;
+    }
+
+    const SimulationLog::Level level = levelInput
+        ? static_cast<SimulationLog::Level>(levelInput->currentData().toInt())
+        : SimulationLog::Debug;
+    LogFilter filter(level);
+    for (int category = 0; category < SimulationLog::CategoryCount; ++category) {
+        QCheckBox *check = categoryChecks[category];
+        if (check && !check->isChecked()) {
+            filter.setCategoryEnabled(static_cast<SimulationLog::Category>(category), false);
+        }
+    }
+    logConsole->setLogFilter(filter);
+}
@@ -0,0 +1,38 @@
+#ifndef LOGFILTERSETUP_H
+#define LOGFILTERSETUP_H
+
+#include <QObject>
+#include <QCheckBox>
+#include <QComboBox>
+#include "LogConsole.h"
+
+/**
+ * @brief The LogFilterSetup class is responsible for setting:
+ *        - The lowest severity level logged
+ *        - The categories logged
+ *        It hands the filter to the log console, which passes it on to the running engine, so hidden messages
+ *        are dropped before they are formatted
+ */
+class LogFilterSetup : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogFilterSetup(QComboBox *levelInput,
+                            QCheckBox *movementCheck,
+                            QCheckBox *passengerCheck,
+                            QCheckBox *safetyCheck,
+                            QCheckBox *lifecycleCheck,
+                            LogConsole *logConsole,
+                            QObject *parent = nullptr);
+
+private slots:
+    void onFilterChanged();
+
+private:
+    QComboBox *levelInput;
+    QCheckBox *categoryChecks[SimulationLog::CategoryCount];
+    LogConsole *logConsole;
+};
+
+#endif // LOGFILTERSETUP_H
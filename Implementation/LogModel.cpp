@@ -0,0 +1,232 @@
+#include "LogModel.h"
+#include <QBrush>
+#include <QColor>
+#include <QStringList>
+#include <algorithm>
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent),
+      ring(qMax(1, capacity)),
+      head(0),
+      count(0),
+      firstSequence(0)
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return query.isEmpty() ? count : static_cast<int>(matchingLines.size());
+}
+
+/**
+ * @brief Text of a line, and a colour for warnings and critical messages. A trip's text is built here, for the
+ *        rows the view draws only, and its floors are the tooltip
+ */
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    const quint64 sequence = query.isEmpty() ? firstSequence + index.row() : matchingLines[index.row()];
+    const Entry &entry = entryAt(sequence);
+    switch (role) {
+    case Qt::DisplayRole:
+        return entry.isTrip ? tripText(entry.trip) : entry.text;
+    case Qt::ToolTipRole:
+        return entry.isTrip ? tripFloorsText(entry.trip) : QVariant();
+    case Qt::ForegroundRole:
+        if (entry.level == SimulationLog::Critical) {
+            return QBrush(QColor(Qt::red));
+        }
+        if (entry.level == SimulationLog::Warning) {
+            return QBrush(QColor(Qt::darkYellow));
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief Drops the oldest lines the new ones replace, then appends the new ones. With a query only the matching
+ *        lines are rows, so the rows removed and inserted are counted on the matches
+ */
+void LogModel::append(const QVector<Line> &lines)
+{
+    const int capacity = ring.size();
+    // Lines of a batch larger than the ring would be dropped right away
+    const int firstKept = qMax(0, lines.size() - capacity);
+    const int added = lines.size() - firstKept;
+    if (added == 0) {
+        return;
+    }
+
+    const int evicted = qMax(0, count + added - capacity);
+    if (evicted > 0) {
+        const quint64 evictedEnd = firstSequence + evicted;
+        int removedRows = evicted;
+        if (!query.isEmpty()) {
+            removedRows = static_cast<int>(std::lower_bound(matchingLines.begin(), matchingLines.end(), evictedEnd)
+                                           - matchingLines.begin());
+        }
+
+        if (removedRows > 0) {
+            beginRemoveRows(QModelIndex(), 0, removedRows - 1);
+        }
+        for (int i = 0; i < evicted; ++i) {
+            removeOldestFromIndex();
+        }
+        if (!query.isEmpty()) {
+            matchingLines.erase(matchingLines.begin(), matchingLines.begin() + removedRows);
+        }
+        if (removedRows > 0) {
+            endRemoveRows();
+        }
+    }
+
+    QVector<Entry> entries;
+    entries.reserve(added);
+    int insertedRows = 0;
+    for (int i = firstKept; i < lines.size(); ++i) {
+        Entry entry;
+        entry.text = lines[i].text;
+        entry.category = lines[i].category;
+        entry.level = lines[i].level;
+        entry.isTrip = lines[i].isTrip;
+        entry.trip = lines[i].trip;
+        entry.carId = lines[i].subject.carId;
+        entry.passengerId = lines[i].subject.passengerId;
+        if (query.isEmpty() || matches(entry)) {
+            ++insertedRows;
+        }
+        entries.append(entry);
+    }
+
+    const int firstRow = rowCount();
+    if (insertedRows > 0) {
+        beginInsertRows(QModelIndex(), firstRow, firstRow + insertedRows - 1);
+    }
+    for (const Entry &entry : entries) {
+        const quint64 sequence = firstSequence + count;
+        ring[slotOf(sequence)] = entry;
+        ++count;
+        addToIndex(entry, sequence);
+        if (!query.isEmpty() && matches(entry)) {
+            matchingLines.push_back(sequence);
+        }
+    }
+    if (insertedRows > 0) {
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief Shows the lines matching the query. The candidates come from the smallest index the query names,
+ *        the other keys are checked on them only
+ */
+void LogModel::setQuery(const Query &newQuery)
+{
+    beginResetModel();
+    query = newQuery;
+    matchingLines.clear();
+
+    if (!query.isEmpty()) {
+        static const SequenceList none;
+        const SequenceList *candidates = nullptr;
+        auto consider = [&candidates](const SequenceList &lines) {
+            if (!candidates || lines.size() < candidates->size()) {
+                candidates = &lines;
+            }
+        };
+        if (query.category >= 0) {
+            consider(query.category < SimulationLog::CategoryCount ? byCategory[query.category] : none);
+        }
+        if (query.carId >= 0) {
+            auto found = byCar.find(query.carId);
+            consider(found != byCar.end() ? found->second : none);
+        }
+        if (query.passengerId >= 0) {
+            auto found = byPassenger.find(query.passengerId);
+            consider(found != byPassenger.end() ? found->second : none);
+        }
+
+        for (quint64 sequence : *candidates) {
+            if (matches(entryAt(sequence))) {
+                matchingLines.push_back(sequence);
+            }
+        }
+    }
+
+    endResetModel();
+}
+
+QString LogModel::tripText(const MovementSegment &trip)
+{
+    return QString("Elevator %1 moving from floor %2 to floor %3...").arg(trip.carId).arg(trip.fromFloor)
+        .arg(trip.toFloor);
+}
+
+QString LogModel::tripFloorsText(const MovementSegment &trip)
+{
+    QStringList floors;
+    floors.reserve(trip.floorCount());
+    for (int floor = 1; floor <= trip.floorCount(); ++floor) {
+        floors.append(QString::fromStdString(trip.floorMessage(floor)));
+    }
+    return floors.join('\n');
+}
+
+int LogModel::slotOf(quint64 sequence) const
+{
+    return static_cast<int>((head + (sequence - firstSequence)) % static_cast<quint64>(ring.size()));
+}
+
+bool LogModel::matches(const Entry &entry) const
+{
+    return (query.category < 0 || entry.category == query.category)
+        && (query.carId < 0 || entry.carId == query.carId)
+        && (query.passengerId < 0 || entry.passengerId == query.passengerId);
+}
+
+void LogModel::addToIndex(const Entry &entry, quint64 sequence)
+{
+    byCategory[entry.category].push_back(sequence);
+    if (entry.carId >= 0) {
+        byCar[entry.carId].push_back(sequence);
+    }
+    if (entry.passengerId >= 0) {
+        byPassenger[entry.passengerId].push_back(sequence);
+    }
+}
+
+/**
+ * @brief Drops the oldest line, which is the first one of every list it is in
+ */
+void LogModel::removeOldestFromIndex()
+{
+    Entry &entry = ring[head];
+    byCategory[entry.category].pop_front();
+    if (entry.carId >= 0) {
+        auto found = byCar.find(entry.carId);
+        found->second.pop_front();
+        if (found->second.empty()) {
+            byCar.erase(found);
+        }
+    }
+    if (entry.passengerId >= 0) {
+        auto found = byPassenger.find(entry.passengerId);
+        found->second.pop_front();
+        if (found->second.empty()) {
+            byPassenger.erase(found);
+        }
+    }
+
+    entry.text.clear();
+    head = (head + 1) % ring.size();
+    --count;
+    ++firstSequence;
+}
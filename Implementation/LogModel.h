@@ -0,0 +1,102 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include "MovementSegment.h"
+#include "SimulationLog.h"
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include <deque>
+#include <unordered_map>
+
+/**
+ * @brief The LogModel class is responsible for keeping the log console's lines:
+ *        - The latest capacity lines in a ring, older ones are dropped so memory stays bounded on long runs
+ *        - A car's trip is a single line holding the MovementSegment, its text and the tooltip listing every
+ *          floor are only built when the view asks for the row
+ *        - An index of the lines by category, by car and by passenger, updated as lines come and go. The car and
+ *          the passenger are the line's subject, given by whoever logged it
+ *        - A query on those keys, the model then only shows the matching lines. The matches are read from the
+ *          smallest index of the query instead of a scan of every line, and kept up to date as lines come and go
+ *        A QListView with uniform item sizes only asks for the rows it draws, so the view's cost does not grow
+ *        with the number of lines either
+ */
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    struct Line {
+        QString text;               // Empty for a trip
+        SimulationLog::Category category;
+        SimulationLog::Level level;
+        SimulationLog::Subject subject;
+        bool isTrip = false;
+        MovementSegment trip;
+    };
+
+    // Lines shown, a negative key matches every line
+    struct Query {
+        int category = -1;
+        int carId = -1;
+        int passengerId = -1;
+
+        bool isEmpty() const { return category < 0 && carId < 0 && passengerId < 0; }
+    };
+
+    static const int defaultCapacity = 100000;
+
+    explicit LogModel(int capacity = defaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // Appends the lines as one row insertion, dropping the oldest lines past the capacity
+    void append(const QVector<Line> &lines);
+
+    void setQuery(const Query &query);
+    const Query &getQuery() const { return query; }
+
+    // Lines kept, whatever the query
+    int getLineCount() const { return count; }
+    int getCapacity() const { return ring.size(); }
+
+private:
+    struct Entry {
+        QString text;
+        SimulationLog::Category category = SimulationLog::Lifecycle;
+        SimulationLog::Level level = SimulationLog::Info;
+        int carId = -1;
+        int passengerId = -1;
+        bool isTrip = false;
+        MovementSegment trip;
+    };
+
+    // Lines are numbered in arrival order, the line numbered sequence is at ring[slotOf(sequence)]
+    typedef std::deque<quint64> SequenceList;
+
+    // "Elevator 2 moving from floor 3 to floor 7", and its floors one "Elevator 2 moving to floor 4..." per line
+    static QString tripText(const MovementSegment &trip);
+    static QString tripFloorsText(const MovementSegment &trip);
+
+    int slotOf(quint64 sequence) const;
+    const Entry &entryAt(quint64 sequence) const { return ring[slotOf(sequence)]; }
+    bool matches(const Entry &entry) const;
+    void addToIndex(const Entry &entry, quint64 sequence);
+    void removeOldestFromIndex();
+
+    QVector<Entry> ring;
+    int head;                   // Slot of the oldest line
+    int count;
+    quint64 firstSequence;      // Number of the oldest line
+
+    // Line numbers by key, ascending. Keys without lines have no list
+    SequenceList byCategory[SimulationLog::CategoryCount];
+    std::unordered_map<int, SequenceList> byCar;
+    std::unordered_map<int, SequenceList> byPassenger;
+
+    Query query;
+    SequenceList matchingLines;  // Lines matching a non-empty query, ascending
+};
+
+#endif // LOGMODEL_H
@@ -35,7 +35,9 @@ PassengerBehaviourSetup::PassengerBehaviourSetup(QLineEdit *passIdInput,
       pushHelpTimeStep(pushHelpTimeStep),
       requestCarBtn(requestCarBtn),
       requestCarFloor(requestCarFloor),
-      requestCarTimeStep(requestCarTimeStep)
+      requestCarTimeStep(requestCarTimeStep),
+      actionList(std::make_shared<const ActionTable>()),
+      actionVersion(0)
 {
     // Connecting buttons
     connect(requestCarBtn, &QPushButton::clicked, this, &PassengerBehaviourSetup::onRequestBtnClicked);
@@ -54,9 +56,11 @@ void PassengerBehaviourSetup::onRequestBtnClicked()
         QString passengerId = passIdInput->text();
         int floor = requestCarFloor->text().toInt();
         int timeStep = requestCarTimeStep->text().toInt();
-        actionList.append(PassengerAction("RequestCar", floor, timeStep));
+        publishAction(PassengerAction(PassengerAction::RequestCar, floor, timeStep, passengerId.toInt()));
                 logConsole->logMessage(QString("Passenger %1 requested car at floor %2 at time step %3.")
-                               .arg(passengerId).arg(floor).arg(timeStep));
+                               .arg(passengerId).arg(floor).arg(timeStep),
+                               SimulationLog::Passenger, SimulationLog::Info,
+                               SimulationLog::passenger(passengerId.toInt()));
     }
 }
 
@@ -69,9 +73,11 @@ void PassengerBehaviourSetup::onExitCarBtnClicked()
         QString passengerId = passIdInput->text();
         int floor = exitCarFloor->text().toInt();
         int timeStep = exitCarTimeStep->text().toInt();
-        actionList.append(PassengerAction("ExitCar", floor, timeStep));
+        publishAction(PassengerAction(PassengerAction::ExitCar, floor, timeStep, passengerId.toInt()));
         logConsole->logMessage(QString("Passenger %1 exited car at floor %2 at time step %3.")
-                               .arg(passengerId).arg(floor).arg(timeStep));
+                               .arg(passengerId).arg(floor).arg(timeStep),
+                               SimulationLog::Passenger, SimulationLog::Info,
+                               SimulationLog::passenger(passengerId.toInt()));
     }
 }
 
@@ -84,9 +90,11 @@ void PassengerBehaviourSetup::onOpenDoorBtnClicked()
         QString passengerId = passIdInput->text();
         int floor = openDoorFloor->text().toInt();
         int timeStep = openDoorTimeStep->text().toInt();
-        actionList.append(PassengerAction("OpenDoor", floor, timeStep));
+        publishAction(PassengerAction(PassengerAction::OpenDoor, floor, timeStep, passengerId.toInt()));
         logConsole->logMessage(QString("Passenger %1 opened door at floor %2 at time step %3.")
-                               .arg(passengerId).arg(floor).arg(timeStep));
+                               .arg(passengerId).arg(floor).arg(timeStep),
+                               SimulationLog::Passenger, SimulationLog::Info,
+                               SimulationLog::passenger(passengerId.toInt()));
     }
 }
 
@@ -99,9 +107,11 @@ void PassengerBehaviourSetup::onCloseDoorBtnClicked()
         QString passengerId = passIdInput->text();
         int floor = closeDoorFloor->text().toInt();
         int timeStep = closeDoorTimeStep->text().toInt();
-        actionList.append(PassengerAction("CloseDoor", floor, timeStep));
+        publishAction(PassengerAction(PassengerAction::CloseDoor, floor, timeStep, passengerId.toInt()));
         logConsole->logMessage(QString("Passenger %1 closed door at floor %2 at time step %3.")
-                               .arg(passengerId).arg(floor).arg(timeStep));
+                               .arg(passengerId).arg(floor).arg(timeStep),
+                               SimulationLog::Passenger, SimulationLog::Info,
+                               SimulationLog::passenger(passengerId.toInt()));
     }
 }
 
@@ -114,12 +124,41 @@ void PassengerBehaviourSetup::onPushHelpBtnClicked()
         QString passengerId = passIdInput->text();
         int floor = pushHelpFloor->text().toInt();
         int timeStep = pushHelpTimeStep->text().toInt();
-        actionList.append(PassengerAction("PushHelp", floor, timeStep));
+        publishAction(PassengerAction(PassengerAction::PushHelp, floor, timeStep, passengerId.toInt()));
         logConsole->logMessage(QString("Passenger %1 pushed help button at floor %2 at time step %3.")
-                               .arg(passengerId).arg(floor).arg(timeStep));
+                               .arg(passengerId).arg(floor).arg(timeStep),
+                               SimulationLog::Passenger, SimulationLog::Info,
+                               SimulationLog::passenger(passengerId.toInt()));
     }
 }
 
+/**
+ * @brief Copies the published actions into a new list with action appended and swaps it in.
+ *        The simulation keeps reading the snapshot it holds, so adding an action never stalls a tick
+ * @param action The new passenger action
+ */
+void PassengerBehaviourSetup::publishAction(const PassengerAction &action)
+{
+    PassengerActionSnapshot current = std::atomic_load(&actionList);
+    auto next = std::make_shared<ActionTable>();
+    next->reserve(current->size() + 1);
+    next->append(*current);
+    next->append(action);
+
+    std::atomic_store(&actionList, PassengerActionSnapshot(std::move(next)));
+    actionVersion.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Swaps in a complete action list, one snapshot and one version bump whatever its size
+ * @param actions The new action list
+ */
+void PassengerBehaviourSetup::replaceActions(const PassengerActionSnapshot &actions)
+{
+    std::atomic_store(&actionList, actions ? actions : std::make_shared<const ActionTable>());
+    actionVersion.fetch_add(1, std::memory_order_release);
+}
+
 /**
  * @brief Displays passenger behaviour setup on log console
  */
@@ -2,7 +2,8 @@
 #define PASSENGERBEHAVIOURSETUP_H
 
 #include "LogConsole.h"
-#include "PassengerAction.h"
+#include "ActionTable.h"
+#include <atomic>
 
 /**
  * @brief The PassengerBehaviourSetup class is responsible for setting passengers':
@@ -40,9 +41,18 @@ class PassengerBehaviourSetup : public QObject {
        // Displays custom passenger behaviour to log console
        void logPassengerBehaviourSetup () const;
 
-       // Returns list of passengers' actions
-       QList<PassengerAction> getActionList() const {
-           return actionList;
+       // Returns an immutable snapshot of the passengers' actions, never copies the list
+       PassengerActionSnapshot getActionSnapshot() const {
+           return std::atomic_load(&actionList);
+       }
+
+       // Publishes actions as the whole list in one step, e.g. a loaded scenario. The engine only accepts
+       // snapshots that grow, so this must not be called while a simulation is running
+       void replaceActions(const PassengerActionSnapshot &actions);
+
+       // Incremented every time a new snapshot is published
+       quint64 getActionVersion() const {
+           return actionVersion.load(std::memory_order_acquire);
        }
 
     // Handles buttons by retrieving time step, floor, passenger id, and adding information to actionList
@@ -71,7 +81,11 @@ class PassengerBehaviourSetup : public QObject {
        QPushButton *requestCarBtn;
        QLineEdit *requestCarFloor;
        QLineEdit *requestCarTimeStep;
-       QList<PassengerAction> actionList;
+       PassengerActionSnapshot actionList;
+       std::atomic<quint64> actionVersion;
+
+       // Publishes a new snapshot holding the current actions plus action, readers keep their old snapshot
+       void publishAction(const PassengerAction &action);
 };
 
 
@@ -1,5 +1,22 @@
 #include "SafetyEventSetup.h"
 
+namespace {
+
+// Indexed by SafetyEvent::Kind
+const char *const eventTitles[SafetyEvent::KindCount] = {"Help", "Door Obstacle", "Fire", "Overload", "Power Out"};
+
+QString formatEvents(const std::vector<SafetyEvent> &events)
+{
+    QStringList entries;
+    for (const SafetyEvent &event : events) {
+        entries << (event.target > 0 ? QString("%1:%2").arg(event.timeStep).arg(event.target)
+                                     : QString::number(event.timeStep));
+    }
+    return entries.join(", ");
+}
+
+}
+
 SafetyEventSetup::SafetyEventSetup(QLineEdit *helpTimeStep,
                                                QLineEdit *doorObstacleTimeStep,
                                                QLineEdit *fireTimeStep,
@@ -13,119 +30,79 @@ SafetyEventSetup::SafetyEventSetup(QLineEdit *helpTimeStep,
                                                LogConsole *logConsole,
                                                QObject *parent)
     : QObject(parent),
-      helpTimeStep(helpTimeStep),
-      doorObstacleTimeStep(doorObstacleTimeStep),
-      fireTimeStep(fireTimeStep),
-      overloadTimeStep(overloadTimeStep),
-      powerOutTimeStep(powerOutTimeStep),
-      helpBtn(helpBtn),
-      doorObstacleBtn(doorObstacleBtn),
-      fireBtn(fireBtn),
-      overloadBtn(overloadBtn),
-      powerOutBtn(powerOutBtn),
+      timeStepInputs{helpTimeStep, doorObstacleTimeStep, fireTimeStep, overloadTimeStep, powerOutTimeStep},
       logConsole(logConsole)
 {
     // Connecting buttons
-    connect(helpBtn, &QPushButton::clicked, this, &SafetyEventSetup::onHelpBtnClicked);
-    connect(doorObstacleBtn, &QPushButton::clicked, this, &SafetyEventSetup::onDoorObstacleBtnClicked);
-    connect(fireBtn, &QPushButton::clicked, this, &SafetyEventSetup::onFireBtnClicked);
-    connect(overloadBtn, &QPushButton::clicked, this, &SafetyEventSetup::onOverloadBtnClicked);
-    connect(powerOutBtn, &QPushButton::clicked, this, &SafetyEventSetup::onPowerOutBtnClicked);
-}
-
-/**
- * @brief Handles Help Button clicked by retrieving time step
- */
-void SafetyEventSetup::onHelpBtnClicked()
-{
-    if (logConsole) {
-        int timeStep = helpTimeStep->text().toInt();
-        logConsole->logMessage(QString("Help button pressed. Triggers at time step: %1").arg(timeStep));
+    QPushButton *buttons[SafetyEvent::KindCount] = {helpBtn, doorObstacleBtn, fireBtn, overloadBtn, powerOutBtn};
+    for (int kind = 0; kind < SafetyEvent::KindCount; ++kind) {
+        if (buttons[kind]) {
+            connect(buttons[kind], &QPushButton::clicked, this, [this, kind]() {
+                onEventBtnClicked(static_cast<SafetyEvent::Kind>(kind));
+            });
+        }
     }
 }
 
 /**
- * @brief Handles Door Obstacle Button clicked by retrieving time step
+ * @brief Handles a safety event button clicked by retrieving the time steps of its kind
  */
-void SafetyEventSetup::onDoorObstacleBtnClicked()
+void SafetyEventSetup::onEventBtnClicked(SafetyEvent::Kind kind)
 {
     if (logConsole) {
-        int timeStep = doorObstacleTimeStep->text().toInt();
-        logConsole->logMessage(QString("Door Obstacle button pressed. Triggers at time step: %1").arg(timeStep));
+        logConsole->logMessage(QString("%1 button pressed. Triggers at time step: %2")
+                               .arg(eventTitles[kind], formatEvents(parseEvents(kind))),
+                               SimulationLog::Safety);
     }
 }
 
-/**
- * @brief Handles Fire Alarm Button clicked by retrieving time step
- */
-void SafetyEventSetup::onFireBtnClicked()
+std::vector<SafetyEvent> SafetyEventSetup::getSafetyEvents() const
 {
-    if (logConsole) {
-        int timeStep = fireTimeStep->text().toInt();
-        logConsole->logMessage(QString("Fire button pressed. Triggers at time step: %1").arg(timeStep));
+    std::vector<SafetyEvent> events;
+    for (int kind = 0; kind < SafetyEvent::KindCount; ++kind) {
+        std::vector<SafetyEvent> kindEvents = parseEvents(static_cast<SafetyEvent::Kind>(kind));
+        events.insert(events.end(), kindEvents.begin(), kindEvents.end());
     }
+    return events;
 }
 
-/**
- * @brief Handles OVerload Alarm Button clicked by retrieving time step
- */
-void SafetyEventSetup::onOverloadBtnClicked()
+void SafetyEventSetup::setSafetyEvents(const std::vector<SafetyEvent> &events)
 {
-    if (logConsole) {
-        int timeStep = overloadTimeStep->text().toInt();
-        logConsole->logMessage(QString("Overload button pressed. Triggers at time step: %1").arg(timeStep));
+    for (int kind = 0; kind < SafetyEvent::KindCount; ++kind) {
+        std::vector<SafetyEvent> kindEvents;
+        for (const SafetyEvent &event : events) {
+            if (event.kind == kind) {
+                kindEvents.push_back(event);
+            }
+        }
+        if (timeStepInputs[kind]) {
+            timeStepInputs[kind]->setText(formatEvents(kindEvents));
+        }
     }
 }
 
 /**
- * @brief Handles Power Out Alarm Button clicked by retrieving time step
+ * @brief Parses "TIMESTEP[:TARGET]" entries separated by commas, a kind without target ignores the target
  */
-void SafetyEventSetup::onPowerOutBtnClicked()
-{
-    if (logConsole) {
-        int timeStep = powerOutTimeStep->text().toInt();
-        logConsole->logMessage(QString("Power Out button pressed. Triggers at time step: %1").arg(timeStep));
-    }
-}
-
-int SafetyEventSetup::getHelpTimeStep() const
-{
-    if (helpTimeStep && !helpTimeStep->text().isEmpty()) {
-        return helpTimeStep->text().toInt();
-    }
-    return -1;
-}
-
-int SafetyEventSetup::getDoorObstacleTimeStep() const
-{
-    if (doorObstacleTimeStep && !doorObstacleTimeStep->text().isEmpty()) {
-        return doorObstacleTimeStep->text().toInt();
-    }
-    return -1;
-}
-
-int SafetyEventSetup::getFireTimeStep() const
+std::vector<SafetyEvent> SafetyEventSetup::parseEvents(SafetyEvent::Kind kind) const
 {
-    if (fireTimeStep && !fireTimeStep->text().isEmpty()) {
-        return fireTimeStep->text().toInt();
+    std::vector<SafetyEvent> events;
+    if (!timeStepInputs[kind]) {
+        return events;
     }
-    return -1;
-}
-
-int SafetyEventSetup::getOverloadTimeStep() const
-{
-    if (overloadTimeStep && !overloadTimeStep->text().isEmpty()) {
-        return overloadTimeStep->text().toInt();
-    }
-    return -1;
-}
 
-int SafetyEventSetup::getPowerOutTimeStep() const
-{
-    if (powerOutTimeStep && !powerOutTimeStep->text().isEmpty()) {
-        return powerOutTimeStep->text().toInt();
+    const bool targeted = SafetyEvent::targetType(kind) != SafetyEvent::NoTarget;
+    for (const QString &entry : timeStepInputs[kind]->text().split(',')) {
+        const QStringList fields = entry.trimmed().split(':');
+        bool validTimeStep = false;
+        bool validTarget = true;
+        const int timeStep = fields[0].trimmed().toInt(&validTimeStep);
+        const int target = fields.size() > 1 && targeted ? fields[1].trimmed().toInt(&validTarget) : 0;
+        if (validTimeStep && validTarget && fields.size() <= 2 && target >= 0) {
+            events.emplace_back(kind, timeStep, target);
+        }
     }
-    return -1;
+    return events;
 }
 
 /**
@@ -137,25 +114,12 @@ void SafetyEventSetup::logSafetyEventParameters() const
         QString message = "Safety Event Setup:\n";
         bool hasInput = false;
 
-        if (helpTimeStep && !helpTimeStep->text().isEmpty()) {
-            message += QString("> Help Event Trigger Time Step: %1\n").arg(helpTimeStep->text().toInt());
-            hasInput = true;
-        }
-        if (doorObstacleTimeStep && !doorObstacleTimeStep->text().isEmpty()) {
-            message += QString("> Door Obstacle Trigger Time Step: %1\n").arg(doorObstacleTimeStep->text().toInt());
-            hasInput = true;
-        }
-        if (fireTimeStep && !fireTimeStep->text().isEmpty()) {
-            message += QString("> Fire Trigger Time Step: %1\n").arg(fireTimeStep->text().toInt());
-            hasInput = true;
-        }
-        if (overloadTimeStep && !overloadTimeStep->text().isEmpty()) {
-            message += QString("> Overload Trigger Time Step: %1\n").arg(overloadTimeStep->text().toInt());
-            hasInput = true;
-        }
-        if (powerOutTimeStep && !powerOutTimeStep->text().isEmpty()) {
-            message += QString("> Power Out Trigger Time Step: %1\n").arg(powerOutTimeStep->text().toInt());
-            hasInput = true;
+        for (int kind = 0; kind < SafetyEvent::KindCount; ++kind) {
+            const std::vector<SafetyEvent> events = parseEvents(static_cast<SafetyEvent::Kind>(kind));
+            if (!events.empty()) {
+                message += QString("> %1 Trigger Time Step: %2\n").arg(eventTitles[kind], formatEvents(events));
+                hasInput = true;
+            }
         }
 
         if (hasInput) {
@@ -163,4 +127,3 @@ void SafetyEventSetup::logSafetyEventParameters() const
         }
     }
 }
-
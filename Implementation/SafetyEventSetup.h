@@ -2,14 +2,18 @@
 #define SAFETYEVENTSETUP_H
 
 #include "LogConsole.h"
+#include "SafetyEvent.h"
+#include <vector>
 
 /**
- * @brief The SafetyEventSetup class is responsible for setting:
- *        - Help Alarm Event and time step
- *        - Door Obstacle Event and time step
- *        - Fire Alarm Event and time step
- *        - Overload Alarm Event and time step
- *        - Power Out Alarm Event and time step
+ * @brief The SafetyEventSetup class is responsible for setting the occurrences of each safety event:
+ *        - Help Alarm Event
+ *        - Door Obstacle Event
+ *        - Fire Alarm Event
+ *        - Overload Alarm Event
+ *        - Power Out Alarm Event
+ *        Each input takes a comma separated list of time steps, a time step may be followed by ":TARGET"
+ *        (the elevator, or the floor of a fire), e.g. "30, 120:2"
  */
 class SafetyEventSetup : public QObject
 {
@@ -32,32 +36,18 @@ class SafetyEventSetup : public QObject
     // Displays log safety event setup on log console
     void logSafetyEventParameters () const;
 
-    // Get functions default to -1 if no input value
-    int getHelpTimeStep() const;
-    int getDoorObstacleTimeStep() const;
-    int getFireTimeStep() const;
-    int getOverloadTimeStep() const;
-    int getPowerOutTimeStep() const;
+    // Parses every input once, in kind order then input order. Invalid entries are skipped
+    std::vector<SafetyEvent> getSafetyEvents() const;
 
-    // Handles buttons by retrieving and storing time steps
-    private slots:
-        void onHelpBtnClicked();
-        void onDoorObstacleBtnClicked();
-        void onFireBtnClicked();
-        void onOverloadBtnClicked();
-        void onPowerOutBtnClicked();
+    // Fills the inputs, e.g. from a loaded scenario, a kind without events clears its input
+    void setSafetyEvents(const std::vector<SafetyEvent> &events);
 
     private:
-        QLineEdit *helpTimeStep;
-        QLineEdit *doorObstacleTimeStep;
-        QLineEdit *fireTimeStep;
-        QLineEdit *overloadTimeStep;
-        QLineEdit *powerOutTimeStep;
-        QPushButton *helpBtn;
-        QPushButton *doorObstacleBtn;
-        QPushButton *fireBtn;
-        QPushButton *overloadBtn;
-        QPushButton *powerOutBtn;
+        // Handles buttons by retrieving the events of their kind
+        void onEventBtnClicked(SafetyEvent::Kind kind);
+        std::vector<SafetyEvent> parseEvents(SafetyEvent::Kind kind) const;
+
+        QLineEdit *timeStepInputs[SafetyEvent::KindCount];
         LogConsole *logConsole;
 
 };
@@ -1,9 +1,35 @@
 #include "SimulationControls.h"
+#include "ScenarioFile.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
+
+namespace {
+
+struct TimeScaleOption {
+    const char *label;
+    double scale; // 0 runs as fast as possible
+};
+
+const TimeScaleOption timeScaleOptions[] = {
+    {"0.1x", 0.1},
+    {"1x", 1.0},
+    {"10x", 10.0},
+    {"100x", 100.0},
+    {"Unthrottled", 0.0}
+};
+
+const int defaultTimeScaleIndex = 1;
+
+}
 
 SimulationControls::SimulationControls(QPushButton *startBtn,
                                        QPushButton *stopBtn,
                                        QPushButton *pauseBtn,
+                                       QPushButton *loadScenarioBtn,
+                                       QPushButton *saveScenarioBtn,
                                        QLineEdit *simTimeOutput,
+                                       QComboBox *timeScaleInput,
                                        LogConsole *logConsole,
                                        BuildingSetup *buildingSetup,
                                        SafetyEventSetup *safetyEventSetup,
@@ -13,29 +39,61 @@ SimulationControls::SimulationControls(QPushButton *startBtn,
       startBtn(startBtn),
       stopBtn(stopBtn),
       pauseBtn(pauseBtn),
+      loadScenarioBtn(loadScenarioBtn),
+      saveScenarioBtn(saveScenarioBtn),
       simTimeOutput(simTimeOutput),
+      timeScaleInput(timeScaleInput),
       logConsole(logConsole),
       buildingSetup(buildingSetup),
       safetyEventSetup(safetyEventSetup),
       passengerBehaviourSetup(passengerBehaviourSetup),
       isPaused(false),
       simulationRunning(false),
-      elapsedTime(0),
-      elevatorCurrentFloor(1),
-      elevatorState(Idle),
-      completedPassengers(0),
-      currentActionIndex(-1),
-      currentFloorInMovement(0)
+      timeScale(timeScaleOptions[defaultTimeScaleIndex].scale),
+      dispatchPolicy(Dispatcher::Collective),
+      runId(0),
+      stopPending(false),
+      startAfterStop(false),
+      scheduledActionVersion(0)
 {
-    // Creating timer for simulation timer
-    timer = new QTimer(this);
-    timer->setInterval(1000); // 1-second interval
+    // The engine runs on its own thread, its frames are queued back to this one
+    qRegisterMetaType<SimulationFrame>();
+    workerThread = new QThread(this);
+    worker = new SimulationWorker();
+    worker->moveToThread(workerThread);
+    connect(workerThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(worker, &SimulationWorker::frameReady, this, &SimulationControls::onFrameReady);
+    workerThread->start();
+
+    // A filter changed mid-run reaches the engine, which then skips formatting the hidden messages
+    if (logConsole) {
+        connect(logConsole, &LogConsole::logFilterChanged, this, [this](const LogFilter &filter) {
+            worker->setLogFilter(filter);
+        });
+    }
+
+    if (timeScaleInput) {
+        for (const TimeScaleOption &option : timeScaleOptions) {
+            timeScaleInput->addItem(option.label, option.scale);
+        }
+        timeScaleInput->setCurrentIndex(defaultTimeScaleIndex);
+        connect(timeScaleInput, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                this, &SimulationControls::onTimeScaleChanged);
+    }
 
     // Connecting buttons
     connect(startBtn, &QPushButton::clicked, this, &SimulationControls::onStartClicked);
     connect(stopBtn, &QPushButton::clicked, this, &SimulationControls::onStopClicked);
     connect(pauseBtn, &QPushButton::clicked, this, &SimulationControls::onPauseClicked);
-    connect(timer, &QTimer::timeout, this, &SimulationControls::onTimeout);
+    connect(loadScenarioBtn, &QPushButton::clicked, this, &SimulationControls::onLoadScenarioClicked);
+    connect(saveScenarioBtn, &QPushButton::clicked, this, &SimulationControls::onSaveScenarioClicked);
+}
+
+SimulationControls::~SimulationControls()
+{
+    // The worker yields to the event loop at least once per frame, so this waits a frame at most
+    workerThread->quit();
+    workerThread->wait();
 }
 
 /**
@@ -43,14 +101,25 @@ SimulationControls::SimulationControls(QPushButton *startBtn,
  */
 void SimulationControls::onStartClicked()
 {
-    if (!timer->isActive()) {
-        timer->start();
+    if (stopPending) {
+        // A new runId now would drop the stopped run's last lines, so the start waits for them
+        startAfterStop = true;
+        return;
+    }
+    if (!simulationRunning || isPaused) {
+        // Read the setup widgets once, the engine only sees this snapshot
+        const quint64 actionVersion = passengerBehaviourSetup ? passengerBehaviourSetup->getActionVersion() : 0;
+        const SimulationConfig config = buildConfig();
+        std::string error;
+        if (!config.validate(error)) {
+            LOG_CONSOLE(logConsole, Lifecycle, Warning,
+                        QString("Cannot start the simulation: %1.").arg(QString::fromStdString(error)));
+            return;
+        }
+
         isPaused = false;
-        elapsedTime = 0;
-        completedPassengers = 0;
         simulationRunning = true;
-        currentActionIndex = -1;
-        currentFloorInMovement = elevatorCurrentFloor;
+        scheduledActionVersion = actionVersion;
 
         // Log setup information
         if (logConsole) {
@@ -65,10 +134,13 @@ void SimulationControls::onStartClicked()
             if (passengerBehaviourSetup) {
                 passengerBehaviourSetup->logPassengerBehaviourSetup();
             }
+            logConsole->logMessage("----------------");
         }
 
-        logConsole->logMessage("----------------");
-        processSimulationStep();
+        // The worker keeps at most half a console ring of lines, past that it waits for the console
+        worker->start(++runId, config, logConsole ? logConsole->getEngineFilter() : LogFilter(), timeScale,
+                      logConsole ? logConsole->getBufferCapacity() / 2 : 0);
+        updateSimTimeOutput(0);
     }
 }
 
@@ -77,422 +149,197 @@ void SimulationControls::onStartClicked()
  */
 void SimulationControls::onStopClicked()
 {
-    if (timer->isActive()) {
-        timer->stop();
+    if (simulationRunning) {
         isPaused = false;
-        elapsedTime = 0;
         simulationRunning = false;
-        currentActionIndex = -1;
-        currentFloorInMovement = elevatorCurrentFloor;
+        stopPending = true;
 
-        logConsole->logMessage("Simulation stopped.");
-        if (simTimeOutput) {
-            simTimeOutput->setText("0");
-        }
+        worker->stop();
+        updateSimTimeOutput(0);
     }
 }
 
 /**
- * @brief Handles Pause Button clicked and toggles simulation timer
+ * @brief Handles Pause Button clicked and pauses or resumes the worker
  */
 void SimulationControls::onPauseClicked()
 {
-    if (timer->isActive() && !isPaused) {
-        timer->stop();
+    if (simulationRunning && !isPaused) {
         isPaused = true;
-        if (logConsole) {
-            logConsole->logMessage("Simulation paused.");
-        }
+        worker->pause();
     } else if (isPaused && simulationRunning) {
-        timer->start();
         isPaused = false;
-        if (logConsole) {
-            logConsole->logMessage("Simulation resumed.");
-        }
+        worker->resume();
     }
 }
 
 /**
- * @brief Increments simulation timer
+ * @brief Displays a frame of the worker: its log lines, and its simulation time while the run goes on.
+ *        The stopped frame ends the run, a start clicked while it was on its way runs now
  */
-void SimulationControls::onTimeout()
+void SimulationControls::onFrameReady(const SimulationFrame &frame)
 {
-    elapsedTime += timer->interval();
-    if (simTimeOutput) {
-        simTimeOutput->setText(QString::number(elapsedTime / 1000));
+    worker->frameConsumed();
+    if (frame.runId != runId) {
+        return;
+    }
+
+    if (logConsole) {
+        for (const SimulationFrame::LogLine &line : frame.logLines) {
+            if (line.isTrip) {
+                logConsole->logTrip(line.trip);
+            } else {
+                logConsole->logMessage(line.message, line.category, line.level, line.subject);
+            }
+        }
     }
 
     if (simulationRunning) {
-        processSimulationStep();
+        updateSimTimeOutput(frame.timeStep);
+        if (frame.running) {
+            scheduleNewActions();
+        } else {
+            simulationRunning = false;
+            isPaused = false;
+        }
+    }
+
+    if (frame.stopped) {
+        stopPending = false;
+        if (startAfterStop) {
+            startAfterStop = false;
+            onStartClicked();
+        }
     }
 }
 
 /**
- * @brief Manages simulation time display
+ * @brief Applies the selected time scale, the time steps already run are kept
+ * @param index Index of the selected time scale option
  */
-void SimulationControls::processSimulationStep()
+void SimulationControls::onTimeScaleChanged(int index)
 {
-    int currentTimeStep = elapsedTime / 1000;
-    int passengerCount = buildingSetup->getPassengerCount();
-
-    // Check if all passengers have reached their destinations
-    if (completedPassengers >= passengerCount) {
-        logConsole->logMessage("----------------");
-        logConsole->logMessage("All passengers have reached their destinations.");
-        logConsole->logMessage("Simulation Complete");
-        timer->stop();
-        simulationRunning = false;
+    if (index < 0 || !timeScaleInput) {
         return;
     }
 
-    logConsole->logMessage("----------------");
-
-    // Process actions that should happen at this time step
-    QList<PassengerAction> actionList = passengerBehaviourSetup->getActionList();
-    bool actionsProcessed = false;
-
-    for (const auto &action : actionList) {
-        if (action.timeStep == currentTimeStep) {
-            executePassengerAction(action, completedPassengers);
-            actionsProcessed = true;
-        }
+    timeScale = timeScaleInput->itemData(index).toDouble();
+    worker->setTimeScale(timeScale);
+    if (logConsole) {
+        logConsole->logMessage("Time scale: " + timeScaleInput->itemText(index));
     }
+}
 
-    // If no scheduled actions, generate random behavior
-    if (!actionsProcessed) {
-        randomizePassengerBehaviour(completedPassengers);
+/**
+ * @brief Handles Load Button clicked, fills every setup from a scenario file.
+ *        The actions are handed over as one snapshot, so nothing is logged or signalled per action
+ */
+void SimulationControls::onLoadScenarioClicked()
+{
+    if (simulationRunning) {
+        LOG_CONSOLE(logConsole, Lifecycle, Warning, QString("Stop the simulation before loading a scenario."));
+        return;
     }
 
-    printElevatorMovement(completedPassengers);
+    QString path = QFileDialog::getOpenFileName(startBtn->window(), "Load Scenario", QString(),
+                                                "Scenario files (*.txt *.scenario);;All files (*)");
+    if (path.isEmpty()) {
+        return;
+    }
 
-    // Check for safety events at this time step
-    processSafetyEvents(currentTimeStep, completedPassengers, passengerCount);
+    SimulationConfig config = buildConfig();
+    std::string error;
+    if (!ScenarioFile::load(QFile::encodeName(path).toStdString(), config, error)) {
+        LOG_CONSOLE(logConsole, Lifecycle, Warning,
+                    QString("Could not load %1: %2").arg(path, QString::fromStdString(error)));
+        return;
+    }
 
-    // Check again if all passengers have been completed after this step
-    if (completedPassengers >= passengerCount) {
-        logConsole->logMessage("----------------");
-        logConsole->logMessage("All passengers have reached their destinations.");
-        logConsole->logMessage("Simulation Complete");
-        timer->stop();
-        simulationRunning = false;
+    if (buildingSetup) {
+        buildingSetup->setParameters(config.passengerCount, config.floorCount, config.elevatorCount);
+    }
+    if (safetyEventSetup) {
+        safetyEventSetup->setSafetyEvents(config.safetyEvents);
     }
+    if (passengerBehaviourSetup) {
+        passengerBehaviourSetup->replaceActions(config.actions);
+    }
+    dispatchPolicy = config.dispatchPolicy;
+    carTiming = config.timing;
 
-    // Minor text output delays
-    QApplication::processEvents();
+    LOG_CONSOLE(logConsole, Lifecycle, Info,
+                QString("Loaded scenario %1: %2 passenger actions.").arg(path).arg(config.actions->size()));
 }
 
 /**
- * @brief Manages passengers' behaviours
- * @param action Passengers' behaviours
- * @param completedPassengers Number of passengers who reached their destination
+ * @brief Handles Save Button clicked, writes every setup to a scenario file
  */
-void SimulationControls::executePassengerAction(const PassengerAction &action, int &completedPassengers)
+void SimulationControls::onSaveScenarioClicked()
 {
-    int passengerCount = buildingSetup->getPassengerCount();
-
-    // Display elevator location and state
-    logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                           .arg(elevatorCurrentFloor)
-                           .arg(elevatorState == Idle ? "Idle" :
-                                elevatorState == Moving ? "Moving" : "Stopped"));
-
-    if (action.actionType == "RequestCar") {
-        logConsole->logMessage(QString("> Passenger requested car at floor %1.").arg(action.floor));
-        elevatorState = Moving;
-        logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                              .arg(elevatorCurrentFloor)
-                              .arg("Moving"));
-
-        // Simulate elevator moving to the requested floor
-        int destinationFloor = action.floor;
-        if (destinationFloor > elevatorCurrentFloor) {
-            logConsole->logMessage("----------------");
-            for (int floor = elevatorCurrentFloor + 1; floor <= destinationFloor; ++floor) {
-                logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-            }
-        } else if (destinationFloor < elevatorCurrentFloor) {
-            logConsole->logMessage("----------------");
-            for (int floor = elevatorCurrentFloor - 1; floor >= destinationFloor; --floor) {
-                logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-            }
-        }
-
-        elevatorCurrentFloor = destinationFloor;
-        elevatorState = Stopped;
-        logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                              .arg(elevatorCurrentFloor)
-                              .arg("Stopped"));
-
-        logConsole->logMessage("> Passenger has entered the elevator.");
-
-    } else if (action.actionType == "ExitCar") {
-        int exitFloor = action.floor;
-        if (elevatorCurrentFloor != exitFloor) {
-            elevatorState = Moving;
-            logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                                  .arg(elevatorCurrentFloor)
-                                  .arg("Moving"));
-
-            if (exitFloor > elevatorCurrentFloor) {
-                logConsole->logMessage("----------------");
-                for (int floor = elevatorCurrentFloor + 1; floor <= exitFloor; ++floor) {
-                    logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-                }
-            } else if (exitFloor < elevatorCurrentFloor) {
-                logConsole->logMessage("----------------");
-                for (int floor = elevatorCurrentFloor - 1; floor >= exitFloor; --floor) {
-                    logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-                }
-            }
-
-            elevatorCurrentFloor = exitFloor;
-        }
-
-        elevatorState = Stopped;
-        logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                              .arg(elevatorCurrentFloor)
-                              .arg("Stopped"));
-
-        logConsole->logMessage(QString("> Passenger exited at floor %1.").arg(exitFloor));
-        completedPassengers++;
-        logConsole->logMessage(QString("Completed passengers: %1/%2")
-                              .arg(completedPassengers).arg(passengerCount));
+    QString path = QFileDialog::getSaveFileName(startBtn->window(), "Save Scenario", QString(),
+                                                "Scenario files (*.txt *.scenario);;All files (*)");
+    if (path.isEmpty()) {
+        return;
     }
 
-    elevatorState = Idle;
-    logConsole->logMessage(QString("Elevator is at floor %1, state: %2.")
-                          .arg(elevatorCurrentFloor)
-                          .arg("Idle"));
-}
+    std::string error;
+    SimulationConfig config = buildConfig();
+    if (!ScenarioFile::save(QFile::encodeName(path).toStdString(), config, error)) {
+        LOG_CONSOLE(logConsole, Lifecycle, Warning,
+                    QString("Could not save %1: %2").arg(path, QString::fromStdString(error)));
+        return;
+    }
 
-/**
- * @brief Randomizes passengers' behaviour and runs "RequestCar" by default
- * @param completedPassengers Tracks number of passengers who reached their destinations
- */
-void SimulationControls::randomizePassengerBehaviour(int &completedPassengers) {
-    int remainingPassengers = buildingSetup->getPassengerCount() - completedPassengers;
-    if (remainingPassengers <= 0) return;
-
-    // Generate random entry floor and have passenger exit on random exit floor
-    int randomFloor = (std::rand() % buildingSetup->getFloorCount()) + 1;
-    PassengerAction randomAction = {"RequestCar", randomFloor, 0};
-    executePassengerAction(randomAction, completedPassengers);
-
-    // Add exit action to complete the passenger's journey
-    // Randomly select a different floor for the passenger to exit at
-    int exitFloor;
-    do {
-        exitFloor = (std::rand() % buildingSetup->getFloorCount()) + 1;
-    } while (exitFloor == randomFloor);
-
-    PassengerAction exitAction = {"ExitCar", exitFloor, 0};
-    executePassengerAction(exitAction, completedPassengers);
+    LOG_CONSOLE(logConsole, Lifecycle, Info,
+                QString("Saved scenario %1: %2 passenger actions.").arg(path).arg(config.actions->size()));
 }
 
-/**
- * @brief Handles safety event cases
- * @param currentTimeStep The current simulation time
- * @param completedPassengers Tracks number of passengers who reached their destinations
- * @param totalPassengers Tracks total number of passengers in simulation
- */
-void SimulationControls::processSafetyEvents(int currentTimeStep, int &completedPassengers, int totalPassengers) {
-    if (safetyEventSetup) {
-        if (currentTimeStep == safetyEventSetup->getHelpTimeStep()) {
-            printSafetyEvent("help", completedPassengers, totalPassengers);
-        }
-        if (currentTimeStep == safetyEventSetup->getDoorObstacleTimeStep()) {
-            printSafetyEvent("doorobstacle", completedPassengers, totalPassengers);
-        }
-        if (currentTimeStep == safetyEventSetup->getFireTimeStep()) {
-            printSafetyEvent("fire", completedPassengers, totalPassengers);
-        }
-        if (currentTimeStep == safetyEventSetup->getOverloadTimeStep()) {
-            printSafetyEvent("overload", completedPassengers, totalPassengers);
-        }
-        if (currentTimeStep == safetyEventSetup->getPowerOutTimeStep()) {
-            printSafetyEvent("powerout", completedPassengers, totalPassengers);
-        }
+void SimulationControls::updateSimTimeOutput(int timeStep)
+{
+    if (simTimeOutput) {
+        simTimeOutput->setText(QString::number(timeStep));
     }
 }
 
 /**
- * @brief Handles displaying elevator movement, accounts for elevators changing between floors to get to destination
- * @param completedPassengers Tracks number of passengers who reached their destinations
+ * @brief Builds the engine's configuration from the building, safety event and passenger behaviour setups
  */
-void SimulationControls::printElevatorMovement(int &completedPassengers) {
-    // Get the action list from PassengerBehaviourSetup
-    QList<PassengerAction> actionList = passengerBehaviourSetup->getActionList();
-    int passengerCount = buildingSetup->getPassengerCount(); // Total number of passengers in simulation
-    static QSet<int> processedActions; // Store indices of processed actions
-    int currentTimeStep = elapsedTime / 1000;
-
-    // Process each action in the action list
-    for (int i = 0; i < actionList.size(); ++i) {
-        const auto &action = actionList[i];
-
-        if (processedActions.contains(i)) {
-            continue; // Skip already processed actions
-        }
-
-        // Skip actions that don't belong to this time step
-        if (action.timeStep != currentTimeStep) {
-            continue;
-        }
-
-        // Check if all passengers have been completed
-        if (completedPassengers >= passengerCount) {
-            break;
-        }
+SimulationConfig SimulationControls::buildConfig() const
+{
+    SimulationConfig config;
 
-        // Simulate the action based on its type
-        if (action.actionType == "OpenDoor") {
-            logConsole->logMessage(QString("> Door opened at floor %1 at time step %2.")
-                                   .arg(action.floor).arg(action.timeStep));
-            processedActions.insert(i);
-        }
-        if (action.actionType == "CloseDoor") {
-            logConsole->logMessage(QString("> Door closed at floor %1 at time step %2.")
-                                   .arg(action.floor).arg(action.timeStep));
-            processedActions.insert(i);
-        }
-        if (action.actionType == "PushHelp") {
-            logConsole->logMessage(QString("> Help button pushed at floor %1 at time step %2.")
-                                   .arg(action.floor).arg(action.timeStep));
-            processedActions.insert(i);
-            // Call the printSafetyEvent function to handle the "help" safety event
-               int passengerCount = buildingSetup->getPassengerCount();
-               printSafetyEvent("help", completedPassengers, passengerCount);
+    if (buildingSetup) {
+        config.passengerCount = buildingSetup->getPassengerCount();
+        config.floorCount = buildingSetup->getFloorCount();
+        config.elevatorCount = buildingSetup->getElevatorCount();
+    }
+    config.dispatchPolicy = dispatchPolicy;
+    config.timing = carTiming;
+    if (safetyEventSetup) {
+        config.safetyEvents = safetyEventSetup->getSafetyEvents();
+    }
+    if (passengerBehaviourSetup) {
+        config.actions = passengerBehaviourSetup->getActionSnapshot();
+    }
 
-        }
-        if (action.actionType == "RequestCar") {
-            logConsole->logMessage(QString("> Passenger requested car at floor %1 at time step %2.")
-                                   .arg(action.floor).arg(action.timeStep));
-
-            // Simulate elevator moving to the requested floor
-            int destinationFloor = action.floor;
-            if (destinationFloor > elevatorCurrentFloor) {
-                logConsole->logMessage("----------------");
-                for (int floor = elevatorCurrentFloor + 1; floor <= destinationFloor; ++floor) {
-                    logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-//                    QThread::msleep(200); // Simulate time between floors
-                }
-            } else if (destinationFloor < elevatorCurrentFloor) {
-                logConsole->logMessage("----------------");
-                for (int floor = elevatorCurrentFloor - 1; floor >= destinationFloor; --floor) {
-                    logConsole->logMessage(QString("Elevator moving to floor %1...").arg(floor));
-//                    QThread::msleep(200); // Simulate time between floors
-                }
-            }
-            elevatorCurrentFloor = destinationFloor; // Update elevator's current floor
+    // Every run of the GUI draws different random passengers and safety event outcomes
+    config.seed = static_cast<std::uint64_t>(QDateTime::currentMSecsSinceEpoch());
 
-            // Passenger enters the elevator
-            logConsole->logMessage("> Passenger has entered the elevator.");
-            processedActions.insert(i);
-        }
-        if (action.actionType == "ExitCar") {
-            logConsole->logMessage(QString("> Passenger exited car at floor %1 at time step %2.")
-                                   .arg(action.floor).arg(action.timeStep));
-
-            // Simulate elevator stopping at the destination floor
-            logConsole->logMessage(QString("> Stopping at floor %1...").arg(action.floor));
-//            QThread::msleep(200);
-
-            // Passenger exits the elevator
-            logConsole->logMessage("> Passenger has exited the elevator.");
-            completedPassengers++;
-            processedActions.insert(i);
-            logConsole->logMessage(QString("Completed passengers: %1/%2")
-                                   .arg(completedPassengers).arg(passengerCount));
-        }
-    }
+    return config;
 }
 
 /**
- * @brief Displays safety events, in each event >= 1 passengers is completed, allowing for runSimulation to reach its base case
- * @param event The safety event
- * @param completedPassengers Tracks the number of passengers who reached their destination
- * @param totalPassengers Tracks the total number of passengers in simulation
- *
+ * @brief Hands the newest action snapshot to the engine when actions were added through the passenger behaviour buttons
  */
-void SimulationControls:: printSafetyEvent(const std::string &event, int &completedPassengers, int totalPassengers)
+void SimulationControls::scheduleNewActions()
 {
-    // Generates random number for handling cases where safety events are resolved or worsen
-    static bool seeded = false;
-    if (!seeded){
-        std::srand(std::time(nullptr));
-        seeded = true;
-    }
-
-    logConsole->logMessage("----------------");
-    if (event == "help"){
-        logConsole->logMessage("Help Alarm Triggered");
-        logConsole->logMessage("> Stay calm, connecting passenger to building safety services.");
-
-        // 50/50 chance that the building safety responds
-        if (std::rand() % 2 == 0){
-            logConsole->logMessage("> Connected to building safety services. Please remain calm, help is on the way");
-        } else {
-            logConsole->logMessage("> Unable to contact building safety services, 911 emergency call has been placed.");
-        }
-        completedPassengers++;
-     }
-
-    if (event == "doorobstacle"){
-        logConsole->logMessage("Door Obstacle Triggered by Light Sensors");
-        logConsole->logMessage("Elevator doors remain open.");
-        logConsole->logMessage("> Please remove the obstacle blocking the door!");
-
-        // 50/50 chance that door obstacle is moved,
-        if (std::rand() % 2 == 0){
-            logConsole->logMessage("> Obstacle has been moved.");
-        } else {
-            logConsole->logMessage("> Obstacle has not been moved.");
-            logConsole->logMessage("> Passengers are asked to disembark.");
-        }
-        completedPassengers++;
-    }
-
-    // Moves either the elevator, or all the elevators to their safe floors
-    if (event == "fire"){
-        logConsole->logMessage("Fire Alarm Triggered");
-        logConsole->logMessage("> Stay calm, moving the elevator(s) to a safe floor.");
-        // 50/50 chance that all elevators experience the fire signal
-        if (std::rand() % 2 == 0){
-            logConsole->logMessage("> All elevators have reached a safe floor, please exit!");
-            completedPassengers += totalPassengers - completedPassengers;
-        } else {
-            logConsole->logMessage("Elevator has reached a safe floor, please exit");
-            completedPassengers++;
-        }
-    }
-
-    if (event == "overload"){
-        logConsole->logMessage("Overload Alarm Triggered");
-        logConsole->logMessage("> Please reduce the weight load before the elevator proceeds.");
-
-        // 50/50 chance that the load is moved
-        if (std::rand() % 2 == 0){
-            logConsole->logMessage("> Load has been moved, elevator will commence.");
-        } else {
-            logConsole->logMessage("Elevator is still overloaded.");
-            logConsole->logMessage("> Passengers are asked to disembark.");
-        }
-        completedPassengers++;
+    if (!passengerBehaviourSetup) {
+        return;
     }
 
-    // All elevators reach their safe floors, and everyone exits, ending the simulation
-    if (event == "powerout") {
-        logConsole->logMessage("Power Out Alarm Triggered");
-        logConsole->logMessage("> Stay calm, moving the elevators to a safe floor.");
-        logConsole->logMessage("> All elevators have reached a safe floor, please exit!");
-        logConsole->logMessage("All passengers have exited the elevators.");
-        completedPassengers += totalPassengers - completedPassengers;
+    quint64 version = passengerBehaviourSetup->getActionVersion();
+    if (version != scheduledActionVersion) {
+        scheduledActionVersion = version;
+        worker->updateActions(passengerBehaviourSetup->getActionSnapshot());
     }
-
-    logConsole->logMessage("Elevator doors open (10 seconds).");
-    logConsole->logMessage("Bell rings.");
-    logConsole->logMessage("Elevator doors closed.");
-    // Log the current progress
-    logConsole->logMessage(QString("Completed passengers: %1/%2")
-                           .arg(completedPassengers).arg(totalPassengers));
 }
@@ -5,23 +5,20 @@
 #include "BuildingSetup.h"
 #include "SafetyEventSetup.h"
 #include "PassengerBehaviourSetup.h"
-#include <QTimer>
-#include <QApplication>
+#include "SimulationWorker.h"
+#include <QComboBox>
 #include <QThread>
-#include <cstdlib>
-#include <ctime>
-#include <algorithm>
-#include <QDebug>
-#include <string>
 
 /**
  * @brief The SimulationControls class is responsible for:
  *        - Running the simulation
  *        - Pausing the simulation
  *        - Stopping the simulation
- *        - Displaying the elevator's movement
- *        - Displaying the safety events and how they're handled
- *        - Displaying passengers' behaviours
+ *        - Handing the setups to the SimulationEngine and displaying its output
+ *        - Loading the setups from a scenario file and saving them to one
+ *        - Scaling simulated time against wall-clock time (one time step is one simulated second)
+ *        The engine runs on a SimulationWorker thread, which publishes the simulation time and the log lines once
+ *        per frame, so the GUI thread never steps the simulation and stays responsive under any load
  */
 class SimulationControls : public QObject
 {
@@ -31,57 +28,57 @@ public:
     explicit SimulationControls(QPushButton *startButton,
                                 QPushButton *stopButton,
                                 QPushButton *pauseButton,
+                                QPushButton *loadScenarioButton,
+                                QPushButton *saveScenarioButton,
                                 QLineEdit *simTimeOutput,
+                                QComboBox *timeScaleInput,
                                 LogConsole *logConsole,
                                 BuildingSetup *buildingSetup,
                                 SafetyEventSetup *safetyEventSetup,
                                 PassengerBehaviourSetup *passengerBehaviourSetup,
                                 QObject *parent = nullptr);
-
-    void runSimulation();
-    void printSafetyEvent(const std::string &event, int &completedPassengers, int totalPassengers);
-    void printElevatorMovement(int &completedPassengers);
-
-    // Helper functions for running elevator simulation
-    void executePassengerAction(const PassengerAction &action, int &completedPassengers);
-    void randomizePassengerBehaviour(int &completedPassengers);
-    void processSafetyEvents(int currentTimeStep, int &completedPassengers, int totalPassengers);
-    void processSimulationStep();
-
-    // For displaying elevator states
-    enum ElevatorState {
-        Idle,
-        Moving,
-        Stopped
-    };
+    ~SimulationControls() override;
 
 private slots:
     void onStartClicked();
     void onStopClicked();
     void onPauseClicked();
-    void onTimeout();
+    void onFrameReady(const SimulationFrame &frame);
+    void onTimeScaleChanged(int index);
+    void onLoadScenarioClicked();
+    void onSaveScenarioClicked();
 
 private:
     QPushButton *startBtn;
     QPushButton *stopBtn;
     QPushButton *pauseBtn;
+    QPushButton *loadScenarioBtn;
+    QPushButton *saveScenarioBtn;
     QLineEdit *simTimeOutput;
+    QComboBox *timeScaleInput;
     LogConsole *logConsole;
     BuildingSetup *buildingSetup;
     SafetyEventSetup *safetyEventSetup;
     PassengerBehaviourSetup *passengerBehaviourSetup;
-    QTimer *timer;
     bool isPaused;
     bool simulationRunning;
-    int elapsedTime;
-    int elevatorCurrentFloor;
-    ElevatorState elevatorState;
-    int completedPassengers;
+    double timeScale;           // Simulated seconds per wall-clock second, 0 when unthrottled
+    Dispatcher::Policy dispatchPolicy; // Has no input, comes from the last loaded scenario
+    CarTiming carTiming;               // Same
+
+    // Builds the engine's configuration from the setup widgets
+    SimulationConfig buildConfig() const;
+    // Hands actions added through the buttons mid-run to the engine
+    void scheduleNewActions();
+    // Shows the simulated time in seconds
+    void updateSimTimeOutput(int timeStep);
 
-    // State tracking for non-blocking elevator movement
-    int currentActionIndex;     // Tracks the current action being processed
-    int currentFloorInMovement; // Tracks the current floor during elevator movement
-    QList<PassengerAction> currentActionList; // Stores the list of actions for the current step
+    QThread *workerThread;
+    SimulationWorker *worker;       // Lives on workerThread, deleted when it finishes
+    quint64 runId;                  // Incremented on every start
+    bool stopPending;               // The last frame of the stopped run has not arrived yet
+    bool startAfterStop;            // Start was clicked while stopPending, the run starts once it arrives
+    quint64 scheduledActionVersion; // Version of the PassengerBehaviourSetup snapshot the engine reads
 };
 
 #endif // SIMULATIONCONTROLS_H
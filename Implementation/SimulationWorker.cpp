@@ -0,0 +1,230 @@
+#include "SimulationWorker.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+// Period of the stepping and of the frames published to the GUI
+const int frameIntervalMs = 16;
+
+// Share of a frame an unthrottled simulation spends stepping before it publishes the frame
+const int unthrottledFrameBudgetMs = 12;
+
+}
+
+SimulationWorker::SimulationWorker(QObject *parent)
+    : QObject(parent),
+      runId(0),
+      timeScale(1.0),
+      stepsAtClockStart(0),
+      maxPendingLines(0),
+      pendingCalls(0),
+      framesInFlight(0)
+{
+    // Created with the worker as parent so it moves to the worker's thread along with it
+    frameTimer = new QTimer(this);
+    frameTimer->setInterval(frameIntervalMs);
+    connect(frameTimer, &QTimer::timeout, this, &SimulationWorker::onFrameTimeout);
+}
+
+/**
+ * @brief Builds a new engine from the configuration snapshot and runs its first time step
+ * @param runId Copied into every frame of the run
+ * @param maxPendingLines Log lines the worker keeps before it stops stepping, 0 for no limit
+ */
+void SimulationWorker::start(quint64 runId, const SimulationConfig &config, const LogFilter &filter,
+                             double timeScale, int maxPendingLines)
+{
+    post([this, runId, config, filter, timeScale, maxPendingLines]() {
+        this->runId = runId;
+        this->timeScale = timeScale;
+        this->maxPendingLines = maxPendingLines;
+        pendingLines.clear();
+
+        engine.reset(new SimulationEngine(config, [this](SimulationLog::Category category,
+                                                         SimulationLog::Level level,
+                                                         const std::string &message,
+                                                         const SimulationLog::Subject &subject) {
+            appendLine(QString::fromStdString(message), category, level, subject);
+        }));
+        engine->setLogFilter(filter);
+        // Only called while the console shows Movement Debug lines or its log file keeps them
+        engine->setMovementSink([this](const MovementSegment &trip) {
+            appendTrip(trip);
+        });
+        engine->start();
+
+        processSimulationStep(1);
+        restartWallClock();
+        if (engine->isRunning()) {
+            frameTimer->start();
+        }
+        publishFrame(true);
+    });
+}
+
+void SimulationWorker::pause()
+{
+    post([this]() {
+        if (!engine || !frameTimer->isActive()) {
+            return;
+        }
+        frameTimer->stop();
+        appendLine("Simulation paused.");
+        appendLatencySummary();
+        publishFrame(true);
+    });
+}
+
+void SimulationWorker::resume()
+{
+    post([this]() {
+        if (!engine || !engine->isRunning() || frameTimer->isActive()) {
+            return;
+        }
+        restartWallClock();
+        frameTimer->start();
+        appendLine("Simulation resumed.");
+    });
+}
+
+/**
+ * @brief Drops the engine. The last frame of the run is always sent, marked stopped, with the lines still
+ *        pending and time step 0
+ */
+void SimulationWorker::stop()
+{
+    post([this]() {
+        frameTimer->stop();
+        if (engine) {
+            engine.reset();
+            appendLine("Simulation stopped.");
+        }
+        publishFrame(true, true);
+    });
+}
+
+/**
+ * @brief Applies the time scale, the time steps already run are kept
+ */
+void SimulationWorker::setTimeScale(double timeScale)
+{
+    post([this, timeScale]() {
+        this->timeScale = timeScale;
+        if (engine && engine->isRunning()) {
+            restartWallClock();
+        }
+    });
+}
+
+void SimulationWorker::updateActions(const PassengerActionSnapshot &snapshot)
+{
+    post([this, snapshot]() {
+        if (engine) {
+            engine->updateActions(snapshot);
+        }
+    });
+}
+
+void SimulationWorker::setLogFilter(const LogFilter &filter)
+{
+    post([this, filter]() {
+        if (engine) {
+            engine->setLogFilter(filter);
+        }
+    });
+}
+
+/**
+ * @brief Runs the time steps due since the last frame and publishes them
+ */
+void SimulationWorker::onFrameTimeout()
+{
+    if (!engine || !engine->isRunning()) {
+        return;
+    }
+
+    if (timeScale > 0) {
+        // The first time step runs on start, then one every 1 / timeScale wall-clock seconds. The engine skips
+        // the time steps without events but never runs ahead of the clock
+        qint64 dueSteps = stepsAtClockStart + static_cast<qint64>(wallClock.elapsed() * timeScale / 1000.0);
+        if (engine->getCurrentTimeStep() < dueSteps &&
+            (maxPendingLines == 0 || pendingLines.size() < maxPendingLines)) {
+            processSimulationStep(static_cast<int>(std::min<qint64>(dueSteps, INT_MAX)));
+        }
+    } else {
+        // Unthrottled: step for most of the frame, and yield early to a queued call or a log backlog
+        QElapsedTimer frameTime;
+        frameTime.start();
+        while (engine->isRunning() && frameTime.elapsed() < unthrottledFrameBudgetMs && pendingCalls == 0 &&
+               (maxPendingLines == 0 || pendingLines.size() < maxPendingLines)) {
+            processSimulationStep();
+        }
+    }
+
+    publishFrame(!engine->isRunning());
+}
+
+/**
+ * @brief Runs the engine and stops the frame timer once the simulation is complete
+ */
+void SimulationWorker::processSimulationStep(int untilTimeStep)
+{
+    PROFILE_SCOPE("SimulationWorker::processSimulationStep");
+
+    if (untilTimeStep < 0) {
+        engine->step();
+    } else {
+        engine->run(untilTimeStep - engine->getCurrentTimeStep());
+    }
+    if (!engine->isRunning()) {
+        frameTimer->stop();
+        appendLatencySummary();
+    }
+}
+
+void SimulationWorker::restartWallClock()
+{
+    stepsAtClockStart = engine ? engine->getCurrentTimeStep() : 0;
+    wallClock.restart();
+}
+
+void SimulationWorker::appendLine(const QString &message, SimulationLog::Category category,
+                                  SimulationLog::Level level, const SimulationLog::Subject &subject)
+{
+    pendingLines.append(SimulationFrame::LogLine{message, category, level, subject, false, MovementSegment()});
+}
+
+void SimulationWorker::appendTrip(const MovementSegment &trip)
+{
+    pendingLines.append(SimulationFrame::LogLine{QString(), SimulationLog::Movement, SimulationLog::Debug,
+                                                 SimulationLog::car(trip.carId), true, trip});
+}
+
+void SimulationWorker::appendLatencySummary()
+{
+    if (!engine || !engine->getLogFilter().isEnabled(SimulationLog::Lifecycle, SimulationLog::Info)) {
+        return;
+    }
+    for (const std::string &line : engine->getMetrics().latency.summary()) {
+        appendLine(QString::fromStdString(line));
+    }
+}
+
+void SimulationWorker::publishFrame(bool force, bool stopped)
+{
+    if (!force && framesInFlight >= maxFramesInFlight) {
+        return;
+    }
+
+    SimulationFrame frame;
+    frame.runId = runId;
+    frame.timeStep = engine ? engine->getCurrentTimeStep() : 0;
+    frame.running = engine && engine->isRunning();
+    frame.stopped = stopped;
+    frame.logLines.swap(pendingLines);
+
+    ++framesInFlight;
+    emit frameReady(frame);
+}
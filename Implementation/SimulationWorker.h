@@ -0,0 +1,112 @@
+#ifndef SIMULATIONWORKER_H
+#define SIMULATIONWORKER_H
+
+#include "SimulationEngine.h"
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief The SimulationFrame struct is what the GUI redraws from once per frame: the simulation time, whether the
+ *        run goes on, and the log lines the engine produced since the previous frame
+ */
+struct SimulationFrame {
+    struct LogLine {
+        QString message;
+        SimulationLog::Category category;
+        SimulationLog::Level level;
+        SimulationLog::Subject subject;
+        bool isTrip;                // A car's trip to its next stop, one line for all its floors
+        MovementSegment trip;
+    };
+
+    quint64 runId = 0;              // Start the frame belongs to, frames of an earlier run are dropped
+    int timeStep = 0;
+    bool running = false;           // False once the simulation completed or was stopped
+    bool stopped = false;           // Last frame of the run, sent in reply to stop()
+    QVector<LogLine> logLines;
+};
+
+Q_DECLARE_METATYPE(SimulationFrame)
+
+/**
+ * @brief The SimulationWorker class is responsible for running the SimulationEngine away from the GUI thread:
+ *        - Stepping the engine once per frame at the selected time scale, or for most of the frame when unthrottled
+ *        - Collecting the engine's log lines and publishing them with the simulation time as one frameReady
+ *          signal per frame, queued to the GUI thread
+ *        - Taking start, pause, resume, stop, time scale and action updates from any thread; they are queued to
+ *          the worker's thread and interrupt unthrottled stepping, so they are handled within one time step
+ *        At most maxFramesInFlight frames wait for the GUI. Past that the lines stay with the worker, and it stops
+ *        stepping once maxPendingLines are waiting, so a slow log console holds the simulation back rather than
+ *        letting the queue grow
+ */
+class SimulationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SimulationWorker(QObject *parent = nullptr);
+
+    // Thread-safe, the calls are queued to the worker's thread in order
+    void start(quint64 runId, const SimulationConfig &config, const LogFilter &filter, double timeScale,
+               int maxPendingLines);
+    void pause();
+    void resume();
+    void stop();
+    // Simulated seconds per wall-clock second, 0 runs as fast as possible
+    void setTimeScale(double timeScale);
+    void updateActions(const PassengerActionSnapshot &snapshot);
+    // Applies a new log filter to the running engine
+    void setLogFilter(const LogFilter &filter);
+
+    // Called by the receiver once it is done with a frame. Thread-safe
+    void frameConsumed() { --framesInFlight; }
+
+    static const int maxFramesInFlight = 2;
+
+signals:
+    void frameReady(const SimulationFrame &frame);
+
+private:
+    // Runs call on the worker's thread, pendingCalls tells the stepping loop to yield to it
+    template <typename Call>
+    void post(Call call) {
+        ++pendingCalls;
+        QMetaObject::invokeMethod(this, [this, call]() {
+            --pendingCalls;
+            call();
+        }, Qt::QueuedConnection);
+    }
+
+    void onFrameTimeout();
+    // Runs the engine to its next event, or up to untilTimeStep when it is not negative
+    void processSimulationStep(int untilTimeStep = -1);
+    void restartWallClock();
+    void appendLine(const QString &message, SimulationLog::Category category = SimulationLog::Lifecycle,
+                    SimulationLog::Level level = SimulationLog::Info,
+                    const SimulationLog::Subject &subject = SimulationLog::Subject());
+    // Appends the trip as one line, the console writes out its floors when it shows them
+    void appendTrip(const MovementSegment &trip);
+    // Appends the wait, ride and journey time percentiles recorded so far
+    void appendLatencySummary();
+    // Sends the pending lines unless maxFramesInFlight frames wait already, force sends them anyway
+    void publishFrame(bool force, bool stopped = false);
+
+    QTimer *frameTimer;
+    std::unique_ptr<SimulationEngine> engine;
+    quint64 runId;
+    double timeScale;
+    QElapsedTimer wallClock;        // Wall-clock time since the simulation was started, resumed or rescaled
+    int stepsAtClockStart;          // Time steps already processed when wallClock was restarted
+    QVector<SimulationFrame::LogLine> pendingLines;
+    int maxPendingLines;
+    std::atomic<int> pendingCalls;
+    std::atomic<int> framesInFlight;
+};
+
+#endif // SIMULATIONWORKER_H
@@ -0,0 +1,153 @@
+#include "BenchmarkReport.h"
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
+namespace {
+
+// Shortest exact-enough form of a value, integers without decimals
+std::string formatValue(double value)
+{
+    char text[32];
+    if (std::isfinite(value) && value == std::floor(value) && std::fabs(value) < 1e15) {
+        std::snprintf(text, sizeof(text), "%.0f", value);
+    } else if (std::isfinite(value)) {
+        std::snprintf(text, sizeof(text), "%.10g", value);
+    } else {
+        return "null";
+    }
+    return text;
+}
+
+std::string csvField(const std::string &field)
+{
+    if (field.find_first_of(",\"\n") == std::string::npos) {
+        return field;
+    }
+    std::string quoted = "\"";
+    for (char c : field) {
+        quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+    }
+    return quoted + "\"";
+}
+
+std::string jsonString(const std::string &text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            quoted += escaped;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string utcDate()
+{
+    char text[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return text;
+}
+
+}
+
+void BenchmarkReport::add(const std::string &suite, const std::string &name, const std::string &metric,
+                          double value, const std::string &unit)
+{
+    results.push_back(Result{suite, name, metric, value, unit});
+}
+
+void BenchmarkReport::write(std::ostream &out, Format format) const
+{
+    switch (format) {
+    case Text:
+        writeText(out);
+        break;
+    case Csv:
+        writeCsv(out);
+        break;
+    case Json:
+        writeJson(out);
+        break;
+    }
+}
+
+bool BenchmarkReport::formatFromName(const std::string &name, Format &format)
+{
+    if (name == "text") {
+        format = Text;
+    } else if (name == "csv") {
+        format = Csv;
+    } else if (name == "json") {
+        format = Json;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief One line per result, a blank line between suites
+ */
+void BenchmarkReport::writeText(std::ostream &out) const
+{
+    char line[256];
+    std::string suite;
+    for (const Result &result : results) {
+        if (result.suite != suite) {
+            suite = result.suite;
+            std::snprintf(line, sizeof(line), "\n%-14s %-44s %-34s %14s  %s\n", suite.c_str(), "case", "metric",
+                          "value", "unit");
+            out << line;
+        }
+        char value[32];
+        std::snprintf(value, sizeof(value), "%.2f", result.value);
+        std::snprintf(line, sizeof(line), "%-14s %-44s %-34s %14s  %s\n", "", result.name.c_str(),
+                      result.metric.c_str(), value, result.unit.c_str());
+        out << line;
+    }
+}
+
+void BenchmarkReport::writeCsv(std::ostream &out) const
+{
+    out << "suite,case,metric,value,unit\n";
+    for (const Result &result : results) {
+        out << csvField(result.suite) << ',' << csvField(result.name) << ',' << csvField(result.metric) << ','
+            << formatValue(result.value) << ',' << csvField(result.unit) << '\n';
+    }
+}
+
+void BenchmarkReport::writeJson(std::ostream &out) const
+{
+#if defined(__clang__)
+    const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    const std::string compiler = "MSVC " + std::to_string(_MSC_VER);
+#else
+    const std::string compiler = "unknown";
+#endif
+    out << "{\n"
+        << "  \"date\": " << jsonString(utcDate()) << ",\n"
+        << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"compiler\": " << jsonString(compiler) << ",\n"
+        << "  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result &result = results[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << "    {\"suite\": " << jsonString(result.suite) << ", \"case\": " << jsonString(result.name)
+            << ", \"metric\": " << jsonString(result.metric) << ", \"value\": " << formatValue(result.value)
+            << ", \"unit\": " << jsonString(result.unit) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
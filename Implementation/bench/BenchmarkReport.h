@@ -0,0 +1,51 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The BenchmarkReport class collects the results of a benchmark run and writes them as:
+ *        - Text, an aligned table for reading in a terminal
+ *        - CSV, one "suite,case,metric,value,unit" row per result
+ *        - JSON, the run's context (date, hardware threads, compiler) and an array of result objects
+ *        Suite, case and metric names are stable, so reports of two releases can be joined on them to spot
+ *        regressions
+ */
+class BenchmarkReport
+{
+public:
+    enum Format {
+        Text,
+        Csv,
+        Json
+    };
+
+    struct Result {
+        std::string suite;      // e.g. "calendar"
+        std::string name;       // Case of the suite, e.g. "actions=100000"
+        std::string metric;     // e.g. "ns_per_step"
+        double value;
+        std::string unit;
+    };
+
+    void add(const std::string &suite, const std::string &name, const std::string &metric, double value,
+             const std::string &unit);
+
+    const std::vector<Result> &getResults() const { return results; }
+
+    void write(std::ostream &out, Format format) const;
+
+    // Parses "text", "csv" or "json", returns false if the name is unknown
+    static bool formatFromName(const std::string &name, Format &format);
+
+private:
+    void writeText(std::ostream &out) const;
+    void writeCsv(std::ostream &out) const;
+    void writeJson(std::ostream &out) const;
+
+    std::vector<Result> results;
+};
+
+#endif // BENCHMARKREPORT_H
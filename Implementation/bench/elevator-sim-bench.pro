@@ -0,0 +1,14 @@
+# Benchmarks for the simulation engine's hot paths, build with optimizations
+TEMPLATE = app
+TARGET = elevator-sim-bench
+CONFIG += console c++17 release
+CONFIG -= qt app_bundle
+
+include(../engine/engine.pri)
+
+SOURCES += \
+    BenchmarkReport.cpp \
+    main.cpp
+
+HEADERS += \
+    BenchmarkReport.h
@@ -0,0 +1,21 @@
+# LogConsole benchmarks, needs Qt widgets but no display (runs on the offscreen platform)
+TEMPLATE = app
+TARGET = elevator-sim-gui-bench
+QT += widgets
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+
+include(../../engine/engine.pri)
+
+INCLUDEPATH += $$PWD/.. $$PWD/../..
+
+SOURCES += \
+    ../BenchmarkReport.cpp \
+    ../../LogConsole.cpp \
+    ../../LogModel.cpp \
+    main.cpp
+
+HEADERS += \
+    ../BenchmarkReport.h \
+    ../../LogConsole.h \
+    ../../LogModel.h
@@ -0,0 +1,196 @@
+#include "BenchmarkReport.h"
+#include "LogConsole.h"
+#include "SimulationEngine.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QListView>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --format FORMAT       text, csv or json (default: text)\n"
+              << "  --output FILE         Write the report to FILE instead of the standard output\n"
+              << "  --quick               Fewer messages, for a quick regression check\n"
+              << "  --help                Show this message\n";
+}
+
+/**
+ * @brief Messages per second through LogConsole::logMessage into the list view, flushes included. The flush rate
+ *        limit is off, so a flush happens every batchSize messages like on a fast machine
+ */
+void benchmarkLogMessage(BenchmarkReport &report, QListView &output, int messageCount, int batchSize)
+{
+    LogConsole console(&output);
+    console.setFlushBatchSize(batchSize);
+    console.setMaxFlushRate(0);
+
+    int flushes = 0;
+    qint64 flushNs = 0;
+    QObject::connect(&console, &LogConsole::flushed, [&flushes, &flushNs](int, qint64 durationNs) {
+        ++flushes;
+        flushNs += durationNs;
+    });
+
+    const QString message = QStringLiteral("Elevator 3 is at floor 17, state: Moving.");
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < messageCount; ++i) {
+        console.logMessage(message, SimulationLog::Movement, SimulationLog::Info);
+    }
+    console.flush();
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    const std::string name = "batch=" + std::to_string(batchSize);
+    report.add("log-console", name, "messages_per_second", messageCount / seconds, "1/s");
+    report.add("log-console", name, "flushes", flushes, "");
+    report.add("log-console", name, "mean_flush_us", flushes > 0 ? flushNs / 1e3 / flushes : 0.0, "us");
+}
+
+// Messages per second of a category the console hides, LOG_CONSOLE skips them before formatting
+void benchmarkFilteredMessage(BenchmarkReport &report, QListView &output, int messageCount)
+{
+    LogConsole console(&output);
+    LogFilter filter;
+    filter.setCategoryEnabled(SimulationLog::Movement, false);
+    console.setLogFilter(filter);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < messageCount; ++i) {
+        LOG_CONSOLE((&console), Movement, Info, QString("Elevator %1 moving to floor %2...").arg(i % 8).arg(i % 100));
+    }
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    report.add("log-console", "movement-filtered", "messages_per_second", messageCount / seconds, "1/s");
+}
+
+// Simulated seconds per wall-clock second of random passengers logged to the console the way the GUI does
+void benchmarkEngineToConsole(BenchmarkReport &report, QListView &output, int passengerCount)
+{
+    LogConsole console(&output);
+    console.setMaxFlushRate(0);
+
+    SimulationConfig config;
+    config.passengerCount = passengerCount;
+    config.floorCount = 50;
+    config.elevatorCount = 8;
+    config.seed = 42;
+    SimulationEngine engine(config, [&console](SimulationLog::Category category, SimulationLog::Level level,
+                                                const std::string &message, const SimulationLog::Subject &subject) {
+        console.logMessage(QString::fromStdString(message), category, level, subject);
+    });
+    engine.setLogFilter(console.getEngineFilter());
+    engine.setMovementSink([&console](const MovementSegment &trip) {
+        console.logTrip(trip);
+    });
+    engine.start();
+
+    QElapsedTimer timer;
+    timer.start();
+    const int steps = engine.run();
+    console.flush();
+    const double seconds = timer.nsecsElapsed() / 1e9;
+
+    const std::string name = "engine/passengers=" + std::to_string(passengerCount);
+    report.add("log-console", name, "simulated_seconds_per_wall_second", steps / seconds, "s/s");
+    report.add("log-console", name, "lines", console.getModel()->getLineCount(), "");
+}
+
+/**
+ * @brief Time to narrow a full model to one car and to one passenger, and to clear the query again. Lines name
+ *        one of 8 cars and one of 10000 passengers, so the queries match about 1/8 and 1/10000 of them
+ */
+void benchmarkQuery(BenchmarkReport &report, QListView &output)
+{
+    LogConsole console(&output);
+    console.setMaxFlushRate(0);
+    LogModel *model = console.getModel();
+    for (int i = 0; i < model->getCapacity(); ++i) {
+        console.logMessage(QString("> Passenger %1 has entered elevator %2.").arg(i % 10000).arg(i % 8),
+                           SimulationLog::Passenger, SimulationLog::Info,
+                           SimulationLog::passenger(i % 10000, i % 8));
+    }
+    console.flush();
+
+    auto measure = [&report, model](const std::string &name, const LogModel::Query &query) {
+        QElapsedTimer timer;
+        timer.start();
+        model->setQuery(query);
+        report.add("log-model", name, "query_ms", timer.nsecsElapsed() / 1e6, "ms");
+        report.add("log-model", name, "rows", model->rowCount(), "");
+    };
+    LogModel::Query byCar;
+    byCar.carId = 3;
+    measure("car", byCar);
+    LogModel::Query byPassenger;
+    byPassenger.passengerId = 43;
+    measure("passenger", byPassenger);
+    LogModel::Query byBoth = byCar;
+    byBoth.passengerId = byPassenger.passengerId;
+    measure("car+passenger", byBoth);
+    measure("none", LogModel::Query());
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // No window is shown, the list view only needs a platform to lay its rows out
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication application(argc, argv);
+
+    bool quick = false;
+    BenchmarkReport::Format format = BenchmarkReport::Text;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strcmp(arg, "--quick") == 0) {
+            quick = true;
+        } else if (std::strcmp(arg, "--format") == 0 && hasValue) {
+            if (!BenchmarkReport::formatFromName(argv[++i], format)) {
+                std::cerr << "Unknown format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--output") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const int messageCount = quick ? 20000 : 200000;
+    QListView output;
+    BenchmarkReport report;
+    for (int batchSize : {64, 1024, 4096}) {
+        benchmarkLogMessage(report, output, messageCount, batchSize);
+    }
+    benchmarkFilteredMessage(report, output, messageCount * 10);
+    benchmarkEngineToConsole(report, output, quick ? 1000 : 10000);
+    benchmarkQuery(report, output);
+
+    if (outputPath.empty()) {
+        report.write(std::cout, format);
+        return 0;
+    }
+    std::ofstream out(outputPath);
+    report.write(out, format);
+    if (!out.flush()) {
+        std::cerr << "Cannot write " << outputPath << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,641 @@
+#include "BenchmarkReport.h"
+#include "IncrementalSimulation.h"
+#include "LogFileWriter.h"
+#include "Profiler.h"
+#include "SimulationEngine.h"
+#include "ReplicationRunner.h"
+#include "ScenarioFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int ticksPerRun = 10000;
+
+const char *const suiteNames[] = {"calendar", "log-filter", "dispatch", "end-to-end", "profiler", "replication",
+                                  "incremental", "scenario-file", "action-layout", "log-file"};
+
+struct BenchmarkOptions {
+    bool quick = false;                 // Smaller sizes, for a quick regression check
+    std::set<std::string> suites;       // Empty runs every suite
+    int layoutActionCount = 10000000;
+
+    bool runs(const char *suite) const { return suites.empty() || suites.count(suite) > 0; }
+};
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options] [LAYOUT_ACTIONS]\n"
+              << "  --format FORMAT       text, csv or json (default: text)\n"
+              << "  --output FILE         Write the report to FILE instead of the standard output\n"
+              << "  --suite NAME          Only run this suite, may be repeated:\n"
+              << "                        calendar, log-filter, dispatch, end-to-end, profiler, replication,\n"
+              << "                        incremental, scenario-file, action-layout, log-file\n"
+              << "  --quick               Smaller sizes, for a quick regression check\n"
+              << "  LAYOUT_ACTIONS        Actions of the action-layout suite (default: 10000000)\n"
+              << "  --help                Show this message\n";
+}
+
+double millisecondsSince(Clock::time_point begin)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+// Fastest of repetitions runs of measure, the other runs only add noise (page faults, frequency scaling)
+template <typename Measure>
+double fastestOf(int repetitions, Measure measure)
+{
+    double fastest = measure();
+    for (int i = 1; i < repetitions; ++i) {
+        fastest = std::min(fastest, measure());
+    }
+    return fastest;
+}
+
+std::string caseName(const char *name, long long value)
+{
+    return std::string(name) + "=" + std::to_string(value);
+}
+
+// Scenario with actionCount door actions spread over actionCount time steps, in random order
+SimulationConfig makeScenario(int actionCount)
+{
+    SimulationConfig config;
+    config.passengerCount = 1;
+    config.floorCount = 10;
+    config.elevatorCount = 1;
+
+    std::vector<int> timeSteps(actionCount);
+    for (int i = 0; i < actionCount; ++i) {
+        timeSteps[i] = i;
+    }
+    std::shuffle(timeSteps.begin(), timeSteps.end(), std::mt19937(42));
+
+    ActionTable actions;
+    actions.reserve(actionCount);
+    for (int timeStep : timeSteps) {
+        actions.append(PassengerAction(PassengerAction::OpenDoor, 1, timeStep));
+    }
+    config.actions = std::make_shared<const ActionTable>(std::move(actions));
+    return config;
+}
+
+// Nanoseconds per time step of the previous approach, which scanned the whole action list every time step
+double linearScanTickCost(const SimulationConfig &config)
+{
+    const std::vector<std::int32_t> &actionTimeSteps = config.actions->getTimeSteps();
+    volatile int dueCount = 0;
+
+    Clock::time_point begin = Clock::now();
+    for (int timeStep = 0; timeStep < ticksPerRun; ++timeStep) {
+        for (std::int32_t actionTimeStep : actionTimeSteps) {
+            if (actionTimeStep == timeStep) {
+                dueCount = dueCount + 1;
+            }
+        }
+    }
+    Clock::time_point end = Clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - begin).count() / ticksPerRun;
+}
+
+// Cost of a processed time step against the number of scheduled actions, the engine pulls the due actions from
+// its event calendar so the cost should stay flat. The linear scan it replaced is measured up to 10^5 actions
+void benchmarkCalendar(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    const int maxActionCount = options.quick ? 100000 : 10000000;
+    for (int actionCount = 100; actionCount <= maxActionCount; actionCount *= 10) {
+        const SimulationConfig config = makeScenario(actionCount);
+        const std::string name = caseName("actions", actionCount);
+
+        double startMs = 0.0;
+        const double stepNs = fastestOf(3, [&config, &startMs]() {
+            SimulationEngine engine(config);
+            Clock::time_point begin = Clock::now();
+            engine.start();
+            startMs = millisecondsSince(begin);
+
+            begin = Clock::now();
+            const int steps = engine.run(ticksPerRun);
+            return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / std::max(1, steps);
+        });
+        report.add("calendar", name, "start_ms", startMs, "ms");
+        report.add("calendar", name, "ns_per_step", stepNs, "ns");
+        if (actionCount <= 100000) {
+            report.add("calendar", name, "linear_scan_ns_per_step", linearScanTickCost(config), "ns");
+        }
+    }
+}
+
+// Nanoseconds per time step of a scenario of random passengers with a no-op sink behind the given filter
+double filteredTickCost(const LogFilter &filter)
+{
+    SimulationConfig config;
+    config.passengerCount = ticksPerRun * 10;
+    config.floorCount = 50;
+    config.elevatorCount = 1;
+
+    SimulationEngine engine(config, [](SimulationLog::Category, SimulationLog::Level, const std::string &,
+                                       const SimulationLog::Subject &) {});
+    engine.setLogFilter(filter);
+    engine.start();
+
+    Clock::time_point begin = Clock::now();
+    int steps = engine.run(ticksPerRun);
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / steps;
+}
+
+void benchmarkLogFilter(BenchmarkReport &report)
+{
+    LogFilter movementDisabled;
+    movementDisabled.setCategoryEnabled(SimulationLog::Movement, false);
+
+    report.add("log-filter", "all-enabled", "ns_per_step", filteredTickCost(LogFilter()), "ns");
+    report.add("log-filter", "movement-disabled", "ns_per_step", filteredTickCost(movementDisabled), "ns");
+    report.add("log-filter", "all-disabled", "ns_per_step", filteredTickCost(LogFilter(SimulationLog::Disabled)), "ns");
+}
+
+// Hall call assignments per second of every policy, on banks of busy cars spread over a 100 floor building
+void benchmarkDispatch(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    const int floorCount = 100;
+    const int maxCarCount = options.quick ? 64 : 1024;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> anyFloor(1, floorCount);
+
+    std::vector<PassengerJourney> journeys(1024);
+    for (PassengerJourney &journey : journeys) {
+        journey.origin = anyFloor(random);
+        do {
+            journey.destination = anyFloor(random);
+        } while (journey.destination == journey.origin);
+    }
+
+    for (int carCount = 4; carCount <= maxCarCount; carCount *= 4) {
+        std::vector<ElevatorCar> cars;
+        for (int i = 0; i < carCount; ++i) {
+            ElevatorCar car(i + 1, floorCount);
+            car.floor = anyFloor(random);
+            for (int stop = random() % 6; stop > 0; --stop) {
+                car.stops.insert(anyFloor(random));
+            }
+            car.direction = car.stops.empty() ? ElevatorCar::None
+                          : car.hasStopAbove() ? ElevatorCar::Up : ElevatorCar::Down;
+            car.state = car.stops.empty() ? ElevatorCar::Idle : ElevatorCar::Moving;
+            car.passengersAssigned = static_cast<int>(car.stops.size());
+            cars.push_back(car);
+        }
+
+        // About the same work for every bank size
+        const int decisions = std::max(1000, 4000000 / carCount);
+        for (int policy = 0; policy < Dispatcher::PolicyCount; ++policy) {
+            std::unique_ptr<Dispatcher> dispatcher = Dispatcher::create(static_cast<Dispatcher::Policy>(policy));
+            volatile int assigned = 0;
+            const double seconds = fastestOf(3, [&]() {
+                Clock::time_point begin = Clock::now();
+                for (int i = 0; i < decisions; ++i) {
+                    assigned = assigned + dispatcher->assign(journeys[i % journeys.size()], cars);
+                }
+                return millisecondsSince(begin) / 1000.0;
+            });
+            report.add("dispatch", std::string(Dispatcher::policyName(dispatcher->policy())) + "/cars="
+                       + std::to_string(carCount), "decisions_per_second", decisions / seconds, "1/s");
+        }
+    }
+}
+
+// Simulated seconds per wall-clock second of random passengers in generated buildings, with the default car
+// timing (one time step per floor and per stop) and with realistic travel, acceleration and door times
+void benchmarkEndToEnd(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    struct Building {
+        int floors;
+        int cars;
+        int passengers;
+    };
+    const int scale = options.quick ? 10 : 1;
+    const Building buildings[] = {{10, 2, 2000 / scale}, {50, 8, 20000 / scale}, {200, 32, 100000 / scale}};
+
+    for (const Building &building : buildings) {
+        for (bool timed : {false, true}) {
+            SimulationConfig config;
+            config.floorCount = building.floors;
+            config.elevatorCount = building.cars;
+            config.passengerCount = building.passengers;
+            config.seed = 42;
+            if (timed) {
+                config.timing.floorTravelSteps = 2;
+                config.timing.accelerationSteps = 1;
+                config.timing.doorDwellSteps = 5;
+            }
+
+            SimulationEngine engine(config);
+            engine.start();
+            Clock::time_point begin = Clock::now();
+            const int steps = engine.run();
+            const double wallMs = millisecondsSince(begin);
+
+            const std::string name = "floors=" + std::to_string(building.floors) + "/cars="
+                                   + std::to_string(building.cars) + "/passengers="
+                                   + std::to_string(building.passengers) + (timed ? "/timed" : "");
+            report.add("end-to-end", name, "simulated_seconds", steps, "s");
+            report.add("end-to-end", name, "wall_ms", wallMs, "ms");
+            report.add("end-to-end", name, "simulated_seconds_per_wall_second", steps / (wallMs / 1000.0), "s/s");
+        }
+    }
+}
+
+// Cost of the profiling scopes: a disabled scope alone, and a silent run with the profiler disabled and enabled.
+// Comparing disabled_ns_per_step with a build using -DELEVATOR_SIM_NO_PROFILING gives the cost of compiling them in
+void benchmarkProfiler(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    const int scopes = 10000000;
+    Profiler::setEnabled(false);
+    const double scopeNs = fastestOf(3, [scopes]() {
+        Clock::time_point begin = Clock::now();
+        for (int i = 0; i < scopes; ++i) {
+            PROFILE_SCOPE("benchmark");
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / scopes;
+    });
+    report.add("profiler", "scope", "disabled_ns_per_scope", scopeNs, "ns");
+
+    SimulationConfig config;
+    config.floorCount = 50;
+    config.elevatorCount = 8;
+    config.passengerCount = options.quick ? 2000 : 20000;
+    config.seed = 42;
+
+    double stepNs[2];
+    for (bool enabled : {false, true}) {
+        Profiler::setEnabled(enabled);
+        stepNs[enabled] = fastestOf(3, [&config]() {
+            SimulationEngine engine(config);
+            engine.start();
+            Clock::time_point begin = Clock::now();
+            const int steps = engine.run();
+            return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / steps;
+        });
+        Profiler::clear();
+    }
+    Profiler::setEnabled(false);
+
+    const std::string name = "passengers=" + std::to_string(config.passengerCount);
+    report.add("profiler", name, "disabled_ns_per_step", stepNs[false], "ns");
+    report.add("profiler", name, "enabled_ns_per_step", stepNs[true], "ns");
+    report.add("profiler", name, "enabled_overhead", (stepNs[true] / stepNs[false] - 1.0) * 100.0, "%");
+}
+
+/**
+ * @brief Cost of logging every line of a run to a file, Movement Debug included, from the engine's side: written
+ *        from the simulation thread with a buffered std::ofstream, and queued to LogFileWriter under each overflow
+ *        policy. max_line_us is the longest the engine waited on one line
+ */
+void benchmarkLogFile(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    const std::string path = "elevator-sim-bench.log";
+    SimulationConfig config;
+    config.floorCount = 50;
+    config.elevatorCount = 8;
+    config.passengerCount = options.quick ? 2000 : 20000;
+    config.seed = 42;
+
+    // Runs the simulation with every line handed to write, the time spent in write is measured per line
+    auto run = [&config](const std::function<void(SimulationLog::Category, SimulationLog::Level,
+                                                  const std::string &)> &write,
+                         long long &lines, double &maxLineUs) {
+        lines = 0;
+        maxLineUs = 0.0;
+        auto sink = [&](SimulationLog::Category category, SimulationLog::Level level, const std::string &message,
+                        const SimulationLog::Subject &) {
+            Clock::time_point begin = Clock::now();
+            write(category, level, message);
+            maxLineUs = std::max(maxLineUs, std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+            ++lines;
+        };
+        SimulationEngine engine(config, sink);
+        engine.setMovementSink([&sink](const MovementSegment &trip) {
+            for (int floors = 1; floors <= trip.floorCount(); ++floors) {
+                sink(SimulationLog::Movement, SimulationLog::Debug, trip.floorMessage(floors),
+                     SimulationLog::car(trip.carId));
+            }
+        });
+        engine.start();
+        Clock::time_point begin = Clock::now();
+        engine.run();
+        return millisecondsSince(begin);
+    };
+
+    const std::string name = "passengers=" + std::to_string(config.passengerCount);
+    long long lines = 0;
+    double maxLineUs = 0.0;
+    {
+        std::ofstream file(path, std::ios::trunc);
+        const double ms = run([&file](SimulationLog::Category, SimulationLog::Level, const std::string &message) {
+            file << message << '\n';
+        }, lines, maxLineUs);
+        report.add("log-file", name + "/ofstream", "ns_per_line", ms * 1e6 / std::max(1LL, lines), "ns");
+        report.add("log-file", name + "/ofstream", "max_line_us", maxLineUs, "us");
+    }
+
+    for (LogFileWriter::OverflowPolicy policy : {LogFileWriter::DropLowSeverity, LogFileWriter::Block}) {
+        const std::string caseName = name + (policy == LogFileWriter::Block ? "/writer-block" : "/writer-drop");
+        LogFileWriter writer;
+        LogFileWriter::Options writerOptions;
+        writerOptions.path = path;
+        writerOptions.maxFileBytes = 0;
+        writerOptions.overflow = policy;
+        std::string error;
+        if (!writer.open(writerOptions, error)) {
+            std::cerr << error << "\n";
+            return;
+        }
+        const double ms = run([&writer](SimulationLog::Category category, SimulationLog::Level level,
+                                        const std::string &message) {
+            writer.write(category, level, message);
+        }, lines, maxLineUs);
+        writer.close(error);
+        report.add("log-file", caseName, "ns_per_line", ms * 1e6 / std::max(1LL, lines), "ns");
+        report.add("log-file", caseName, "max_line_us", maxLineUs, "us");
+        report.add("log-file", caseName, "dropped_lines", static_cast<double>(writer.getDroppedCount()), "");
+    }
+    std::remove(path.c_str());
+}
+
+// Replications per second from one thread up to every hardware thread, speedup is relative to one thread
+void benchmarkReplicationScaling(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    SimulationConfig config;
+    config.passengerCount = 100;
+    config.floorCount = 20;
+    config.elevatorCount = 4;
+    config.safetyEvents.emplace_back(SafetyEvent::Fire, 60);
+    config.seed = 42;
+
+    const int replications = options.quick ? 200 : 2000;
+    const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    ReplicationRunner runner(config);
+
+    double singleThreadRate = 0.0;
+    for (int threads = 1; threads <= hardwareThreads; threads *= 2) {
+        runner.setThreadCount(threads);
+        Clock::time_point begin = Clock::now();
+        runner.run(replications, config.seed);
+        double rate = replications / (millisecondsSince(begin) / 1000.0);
+        if (threads == 1) {
+            singleThreadRate = rate;
+        }
+        const std::string name = caseName("threads", threads);
+        report.add("replication", name, "replications_per_second", rate, "1/s");
+        report.add("replication", name, "speedup", rate / singleThreadRate, "x");
+    }
+}
+
+// One action edited at 10%, 50% and 90% of a run: re-simulated by IncrementalSimulation from the last checkpoint
+// before the edit until the run matches the previous one again, against a full re-run of the edited scenario
+void benchmarkIncremental(BenchmarkReport &report, const BenchmarkOptions &options)
+{
+    SimulationConfig config;
+    config.passengerCount = options.quick ? 2000 : 20000;
+    config.floorCount = 50;
+    config.elevatorCount = 8;
+    config.seed = 42;
+
+    // Trips of the first passengers spread over the time steps the random passengers arrive in, their IDs are
+    // below the random passengers' so an edit does not renumber them
+    const int trips = 200;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> floor(1, config.floorCount);
+    ActionTable actions;
+    for (int trip = 0; trip < trips; ++trip) {
+        const int timeStep = static_cast<int>(static_cast<long long>(trip) * config.passengerCount / trips);
+        actions.append(PassengerAction(PassengerAction::RequestCar, floor(random), timeStep, trip + 1));
+        actions.append(PassengerAction(PassengerAction::ExitCar, floor(random), timeStep + 1, trip + 1));
+    }
+    config.actions = std::make_shared<const ActionTable>(actions);
+
+    for (int percent : {10, 50, 90}) {
+        // The trip at percent of the run goes to the next floor
+        const std::size_t exitIndex = 2 * static_cast<std::size_t>(trips * percent / 100) + 1;
+        PassengerAction exit = actions.at(exitIndex);
+        exit.floor = exit.floor % config.floorCount + 1;
+        ActionTable edited = actions;
+        edited.replace(exitIndex, exit);
+        const PassengerActionSnapshot editedActions = std::make_shared<const ActionTable>(std::move(edited));
+
+        IncrementalSimulation simulation(config, 100);
+        simulation.run();
+        Clock::time_point begin = Clock::now();
+        const IncrementalSimulation::Outcome &outcome = simulation.editActions(editedActions);
+        const double incrementalMs = millisecondsSince(begin);
+
+        SimulationConfig editedConfig = config;
+        editedConfig.actions = editedActions;
+        SimulationEngine engine(editedConfig);
+        begin = Clock::now();
+        engine.start();
+        const int steps = engine.run();
+        const double fullMs = millisecondsSince(begin);
+
+        const bool sameOutcome = outcome.steps == steps
+                              && outcome.completedPassengers == engine.getCompletedPassengers()
+                              && outcome.metrics.journeysCompleted == engine.getMetrics().journeysCompleted
+                              && outcome.metrics.totalWaitSteps == engine.getMetrics().totalWaitSteps
+                              && outcome.metrics.totalRideSteps == engine.getMetrics().totalRideSteps;
+        const std::string name = caseName("edit-at-percent", percent);
+        report.add("incremental", name, "incremental_ms", incrementalMs, "ms");
+        report.add("incremental", name, "full_rerun_ms", fullMs, "ms");
+        report.add("incremental", name, "speedup", fullMs / incrementalMs, "x");
+        report.add("incremental", name, "simulated_seconds", simulation.getLastStats().simulatedSteps, "s");
+        report.add("incremental", name, "same_outcome", sameOutcome, "bool");
+    }
+}
+
+// Writes and reads back a scenario file of actionCount passenger actions
+void benchmarkScenarioFile(BenchmarkReport &report, int actionCount)
+{
+    SimulationConfig config = makeScenario(actionCount);
+    std::stringstream file;
+
+    Clock::time_point begin = Clock::now();
+    ScenarioFile::write(file, config);
+    double writeMs = millisecondsSince(begin);
+    const std::size_t bytes = file.str().size();
+
+    SimulationConfig loaded;
+    std::string error;
+    begin = Clock::now();
+    bool ok = ScenarioFile::read(file, loaded, error);
+    double readMs = millisecondsSince(begin);
+
+    const std::string name = caseName("actions", actionCount);
+    report.add("scenario-file", name, "size", bytes / 1e6, "MB");
+    report.add("scenario-file", name, "write_ms", writeMs, "ms");
+    report.add("scenario-file", name, "read_ms", readMs, "ms");
+    report.add("scenario-file", name, "round_trip_ok", ok && loaded.actions->size() == config.actions->size(), "bool");
+}
+
+// The action record before PassengerAction became a 16 byte POD, dispatched with string comparisons
+struct StringPassengerAction {
+    std::string actionType;
+    int floor;
+    int timeStep;
+};
+
+const char *const layoutTypeNames[] = {"RequestCar", "ExitCar", "OpenDoor", "CloseDoor", "PushHelp"};
+
+// Loads, filters and runs layoutActionCount actions with the string record layout and with the ActionTable
+void benchmarkActionLayout(BenchmarkReport &report, int layoutActionCount)
+{
+    const std::string strings = caseName("string-records/actions", layoutActionCount);
+    const std::string table = caseName("action-table/actions", layoutActionCount);
+
+    // Load
+    Clock::time_point begin = Clock::now();
+    std::vector<StringPassengerAction> records;
+    records.reserve(layoutActionCount);
+    for (int i = 0; i < layoutActionCount; ++i) {
+        records.push_back(StringPassengerAction{layoutTypeNames[i % 5], i % 100 + 1, i});
+    }
+    report.add("action-layout", strings, "load_ms", millisecondsSince(begin), "ms");
+
+    begin = Clock::now();
+    ActionTable actions;
+    actions.reserve(layoutActionCount);
+    for (int i = 0; i < layoutActionCount; ++i) {
+        actions.append(PassengerAction(static_cast<PassengerAction::Type>(i % 5), i % 100 + 1, i));
+    }
+    report.add("action-layout", table, "load_ms", millisecondsSince(begin), "ms");
+
+    report.add("action-layout", strings, "bytes_per_action",
+               static_cast<double>(records.capacity() * sizeof(StringPassengerAction)) / layoutActionCount, "B");
+    report.add("action-layout", table, "bytes_per_action",
+               static_cast<double>(actions.memoryUsage()) / layoutActionCount, "B");
+
+    // Filter every RequestCar action
+    begin = Clock::now();
+    volatile std::size_t recordMatches = 0;
+    for (const StringPassengerAction &record : records) {
+        recordMatches = recordMatches + (record.actionType == "RequestCar");
+    }
+    report.add("action-layout", strings, "type_filter_ms", millisecondsSince(begin), "ms");
+
+    begin = Clock::now();
+    volatile std::size_t tableMatches = actions.countOfType(PassengerAction::RequestCar);
+    report.add("action-layout", table, "type_filter_ms", millisecondsSince(begin), "ms");
+    (void)tableMatches;
+
+    // Build the calendar and run the first time steps of the scenario on the engine
+    SimulationConfig config;
+    config.passengerCount = layoutActionCount;
+    config.floorCount = 100;
+    config.elevatorCount = 1;
+    config.actions = std::make_shared<const ActionTable>(std::move(actions));
+
+    begin = Clock::now();
+    SimulationEngine engine(config);
+    engine.start();
+    engine.run(ticksPerRun);
+    report.add("action-layout", table, "start_run_ms", millisecondsSince(begin), "ms");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    BenchmarkReport::Format format = BenchmarkReport::Text;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strcmp(arg, "--quick") == 0) {
+            options.quick = true;
+        } else if (std::strcmp(arg, "--format") == 0 && hasValue) {
+            if (!BenchmarkReport::formatFromName(argv[++i], format)) {
+                std::cerr << "Unknown format " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--output") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (std::strcmp(arg, "--suite") == 0 && hasValue) {
+            const std::string suite = argv[++i];
+            if (std::find(std::begin(suiteNames), std::end(suiteNames), suite) == std::end(suiteNames)) {
+                std::cerr << "Unknown suite " << suite << "\n";
+                return 1;
+            }
+            options.suites.insert(suite);
+        } else if (arg[0] != '-' && std::atoi(arg) > 0) {
+            options.layoutActionCount = std::atoi(arg);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.quick) {
+        options.layoutActionCount = std::min(options.layoutActionCount, 1000000);
+    }
+
+    BenchmarkReport report;
+    if (options.runs("calendar")) {
+        benchmarkCalendar(report, options);
+    }
+    if (options.runs("log-filter")) {
+        benchmarkLogFilter(report);
+    }
+    if (options.runs("dispatch")) {
+        benchmarkDispatch(report, options);
+    }
+    if (options.runs("end-to-end")) {
+        benchmarkEndToEnd(report, options);
+    }
+    if (options.runs("profiler")) {
+        benchmarkProfiler(report, options);
+    }
+    if (options.runs("replication")) {
+        benchmarkReplicationScaling(report, options);
+    }
+    if (options.runs("incremental")) {
+        benchmarkIncremental(report, options);
+    }
+    if (options.runs("scenario-file")) {
+        benchmarkScenarioFile(report, options.quick ? 100000 : 1000000);
+    }
+    if (options.runs("action-layout")) {
+        benchmarkActionLayout(report, options.layoutActionCount);
+    }
+    if (options.runs("log-file")) {
+        benchmarkLogFile(report, options);
+    }
+
+    if (outputPath.empty()) {
+        report.write(std::cout, format);
+        return 0;
+    }
+    std::ofstream out(outputPath);
+    report.write(out, format);
+    if (!out.flush()) {
+        std::cerr << "Cannot write " << outputPath << "\n";
+        return 1;
+    }
+    return 0;
+}
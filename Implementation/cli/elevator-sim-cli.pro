@@ -0,0 +1,10 @@
+# Command line runner, steps a scenario to completion without a display or wall-clock timer
+TEMPLATE = app
+TARGET = elevator-sim-cli
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../engine/engine.pri)
+
+SOURCES += \
+    main.cpp
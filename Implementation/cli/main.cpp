@@ -0,0 +1,646 @@
+#include "SimulationEngine.h"
+#include "CheckpointFile.h"
+#include "IncrementalSimulation.h"
+#include "LogFileWriter.h"
+#include "Profiler.h"
+#include "ReplicationRunner.h"
+#include "ScenarioFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --scenario FILE       Load a scenario file, the options after it override its values\n"
+              << "  --save-scenario FILE  Write the scenario to FILE instead of running it\n"
+              << "  --binary-scenario FILE\n"
+              << "                        Stream the actions of a binary scenario from a memory mapping,\n"
+              << "                        the options after it override its header\n"
+              << "  --save-binary FILE    Write the scenario as a binary scenario instead of running it\n"
+              << "  --passengers N        Number of passengers\n"
+              << "  --floors N            Number of floors\n"
+              << "  --elevators N         Number of elevators\n"
+              << "  --action TYPE,F,T[,ID] Passenger action (RequestCar, ExitCar, OpenDoor, CloseDoor, PushHelp)\n"
+              << "                        at floor F and time step T by passenger ID, may be repeated.\n"
+              << "                        A RequestCar goes to the floor of the same passenger's next ExitCar\n"
+              << "  --help-alarm T[,CAR]  Help alarm at time step T, optionally in elevator CAR\n"
+              << "  --door-obstacle T[,CAR]\n"
+              << "                        Door obstacle at time step T, optionally at elevator CAR\n"
+              << "  --fire T[,FLOOR]      Fire alarm at time step T, optionally on floor FLOOR\n"
+              << "  --overload T[,CAR]    Overload alarm at time step T, optionally in elevator CAR\n"
+              << "  --power-out T         Power out alarm at time step T\n"
+              << "                        Safety event options may be repeated and add to the scenario's events\n"
+              << "  --floor-travel N      Time steps a car takes per floor (default: 1)\n"
+              << "  --acceleration N      Time steps added when a car leaves or approaches a stop (default: 0)\n"
+              << "  --door-dwell N        Time steps a car stays at a stop (default: 1)\n"
+              << "  --safety-door-hold N  Time steps a safety event holds the doors open (default: 10)\n"
+              << "  --dispatcher POLICY   nearest, collective, destination or all to compare them (default: collective)\n"
+              << "  --seed N              Seed of the random passengers and safety event outcomes\n"
+              << "  --replications N      Run N independently seeded replications and print the outcome distributions\n"
+              << "  --threads N           Worker threads of the replications (default: every hardware thread)\n"
+              << "  --what-if TYPE,F,T[,ID]\n"
+              << "                        Run the scenario, then again with this action added, re-simulating only\n"
+              << "                        from the last checkpoint before it. May be repeated, each run adds one more\n"
+              << "                        action; prints the outcome of every run\n"
+              << "  --max-steps N         Stop after N time steps (default: no limit)\n"
+              << "  --checkpoint FILE     Save the run state to FILE every --checkpoint-every time steps and at the end\n"
+              << "  --checkpoint-every N  Time steps between two checkpoints (default: 10000)\n"
+              << "  --resume FILE         Continue the run from a checkpoint saved with the same scenario options\n"
+              << "  --latency-report FILE Write wait, ride and journey time percentiles per floor and per car to FILE (CSV)\n"
+              << "  --latency-every N     Also rewrite the latency report every N time steps while running\n"
+              << "  --passenger-report FILE\n"
+              << "                        Write every passenger's state, car and request, board and exit time steps\n"
+              << "                        to FILE (CSV) at the end of the run\n"
+              << "  --profile FILE        Write the time spent in the simulation steps to FILE as a Chrome trace (JSON)\n"
+              << "  --log-level LEVEL     Minimum level printed: debug, info, warning, critical (default: debug)\n"
+              << "  --log-categories LIST Comma separated categories printed: movement, passenger, safety, lifecycle\n"
+              << "                        (default: all)\n"
+              << "  --log-file FILE       Also write the log to FILE from a background thread\n"
+              << "  --log-file-size MB    Size at which FILE is rotated to FILE.1, FILE.1 to FILE.2... (default: 64, 0: never)\n"
+              << "  --log-file-keep N     Rotated files kept (default: 5)\n"
+              << "  --log-file-compress   Gzip the rotated files (needs a build with ELEVATOR_SIM_WITH_ZLIB)\n"
+              << "  --log-file-overflow POLICY\n"
+              << "                        When the disk falls behind: drop (debug and info lines, default) or block\n"
+              << "  --quiet               Only print the summary\n"
+              << "  --help                Show this message\n";
+}
+
+// Parses "TYPE,FLOOR,TIMESTEP[,PASSENGERID]" into a passenger action
+bool parseAction(const std::string &text, ActionTable &actions)
+{
+    std::size_t first = text.find(',');
+    std::size_t second = first == std::string::npos ? std::string::npos : text.find(',', first + 1);
+    PassengerAction::Type type;
+    if (second == std::string::npos || !PassengerAction::typeFromName(text.substr(0, first), type)) {
+        return false;
+    }
+
+    std::size_t third = text.find(',', second + 1);
+    int passengerId = third == std::string::npos ? 0 : std::atoi(text.substr(third + 1).c_str());
+    actions.append(PassengerAction(type,
+                                   std::atoi(text.substr(first + 1, second - first - 1).c_str()),
+                                   std::atoi(text.substr(second + 1, third - second - 1).c_str()),
+                                   passengerId));
+    return true;
+}
+
+// Parses "TIMESTEP[,TARGET]" into a safety event of the kind
+void addSafetyEvent(SimulationConfig &config, SafetyEvent::Kind kind, const std::string &text)
+{
+    const std::size_t comma = text.find(',');
+    const int target = comma == std::string::npos ? 0 : std::atoi(text.substr(comma + 1).c_str());
+    config.safetyEvents.emplace_back(kind, std::atoi(text.substr(0, comma).c_str()), std::max(0, target));
+}
+
+// Parses a level name returned by SimulationLog::levelName
+bool parseLevel(const std::string &text, SimulationLog::Level &level)
+{
+    for (int i = SimulationLog::Debug; i <= SimulationLog::Critical; ++i) {
+        if (text == SimulationLog::levelName(static_cast<SimulationLog::Level>(i))) {
+            level = static_cast<SimulationLog::Level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parses "movement,passenger,..." into the set of enabled categories
+bool parseCategories(const std::string &text, bool enabled[SimulationLog::CategoryCount])
+{
+    std::fill(enabled, enabled + SimulationLog::CategoryCount, false);
+
+    std::size_t begin = 0;
+    while (begin <= text.size()) {
+        std::size_t end = text.find(',', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+
+        std::string name = text.substr(begin, end - begin);
+        bool found = false;
+        for (int i = 0; i < SimulationLog::CategoryCount; ++i) {
+            if (name == SimulationLog::categoryName(static_cast<SimulationLog::Category>(i))) {
+                enabled[i] = true;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+struct CheckpointOptions {
+    std::string savePath;
+    std::string resumePath;
+    int interval = 10000;
+};
+
+struct LatencyReportOptions {
+    std::string path;
+    int interval = 0;           // 0 writes the report at the end only
+};
+
+struct RunResult {
+    int steps = 0;
+    double elapsedMs = 0.0;
+    bool running = false;
+    int completedPassengers = 0;
+    SimulationMetrics metrics;
+    std::string error;
+};
+
+RunResult runSimulation(const SimulationConfig &config, const SimulationEngine::LogSink &sink,
+                        const LogFilter &filter, int maxSteps,
+                        const CheckpointOptions &checkpoint = CheckpointOptions(),
+                        const LatencyReportOptions &latencyReport = LatencyReportOptions(),
+                        const std::string &passengerReportPath = std::string())
+{
+    SimulationEngine engine(config, sink);
+    engine.setLogFilter(filter);
+    if (sink) {
+        // Every floor of a trip is printed, as the car reaches its stop
+        engine.setMovementSink([&sink](const MovementSegment &trip) {
+            for (int floors = 1; floors <= trip.floorCount(); ++floors) {
+                sink(SimulationLog::Movement, SimulationLog::Debug, trip.floorMessage(floors),
+                     SimulationLog::car(trip.carId));
+            }
+        });
+    }
+    RunResult result;
+
+    auto begin = std::chrono::steady_clock::now();
+    engine.start();
+    if (!checkpoint.resumePath.empty()) {
+        SimulationState state;
+        if (!CheckpointFile::load(checkpoint.resumePath, config, state, result.error)) {
+            result.error = "Checkpoint error: " + result.error;
+            return result;
+        }
+        if (!engine.restoreState(state)) {
+            result.error = "Checkpoint error: the checkpoint does not fit the scenario";
+            return result;
+        }
+    }
+
+    const int checkpointInterval = checkpoint.savePath.empty() ? 0 : std::max(1, checkpoint.interval);
+    const int reportInterval = latencyReport.path.empty() ? 0 : std::max(0, latencyReport.interval);
+    if (checkpointInterval == 0 && reportInterval == 0) {
+        result.steps = engine.run(maxSteps);
+    } else {
+        // Runs up to the next checkpoint or report, whichever comes first
+        bool finished = false;
+        do {
+            int chunk = 0;
+            for (int interval : {checkpointInterval, reportInterval}) {
+                if (interval > 0) {
+                    const int untilNext = interval - result.steps % interval;
+                    chunk = chunk > 0 ? std::min(chunk, untilNext) : untilNext;
+                }
+            }
+            if (maxSteps >= 0) {
+                chunk = std::min(chunk, maxSteps - result.steps);
+            }
+            result.steps += engine.run(chunk);
+            finished = !engine.isRunning() || (maxSteps >= 0 && result.steps >= maxSteps);
+
+            if (checkpointInterval > 0 && (finished || result.steps % checkpointInterval == 0)
+                && !CheckpointFile::save(checkpoint.savePath, config, engine.getState(), result.error)) {
+                result.error = "Checkpoint error: " + result.error;
+                return result;
+            }
+            if (reportInterval > 0 && !finished && result.steps % reportInterval == 0
+                && !engine.getMetrics().latency.saveCsv(latencyReport.path, result.error)) {
+                result.error = "Latency report error: " + result.error;
+                return result;
+            }
+        } while (!finished);
+    }
+    if (!latencyReport.path.empty() && !engine.getMetrics().latency.saveCsv(latencyReport.path, result.error)) {
+        result.error = "Latency report error: " + result.error;
+        return result;
+    }
+    if (!passengerReportPath.empty() && !engine.getPassengers().saveCsv(passengerReportPath, result.error)) {
+        result.error = "Passenger report error: " + result.error;
+        return result;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.elapsedMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    result.running = engine.isRunning();
+    result.completedPassengers = engine.getCompletedPassengers();
+    result.metrics = engine.getMetrics();
+    return result;
+}
+
+// Runs the same scenario under every dispatch policy and prints one row per policy
+int comparePolicies(SimulationConfig config, int maxSteps)
+{
+    std::cout << std::left << std::setw(14) << "policy"
+              << std::right << std::setw(8) << "steps"
+              << std::setw(12) << "completed"
+              << std::setw(16) << "throughput/min"
+              << std::setw(12) << "avg wait"
+              << std::setw(12) << "avg ride" << "\n"
+              << std::fixed << std::setprecision(1);
+
+    bool anyRunning = false;
+    for (int i = 0; i < Dispatcher::PolicyCount; ++i) {
+        config.dispatchPolicy = static_cast<Dispatcher::Policy>(i);
+        // Every policy sees the same random passengers, config.seed is shared
+        RunResult result = runSimulation(config, SimulationEngine::LogSink(), LogFilter(SimulationLog::Disabled),
+                                         maxSteps);
+        anyRunning = anyRunning || result.running;
+
+        std::cout << std::left << std::setw(14) << Dispatcher::policyName(config.dispatchPolicy)
+                  << std::right << std::setw(8) << result.steps
+                  << std::setw(12) << result.completedPassengers
+                  << std::setw(16) << result.metrics.throughputPerMinute()
+                  << std::setw(12) << result.metrics.averageWait()
+                  << std::setw(12) << result.metrics.averageRide() << "\n";
+    }
+    return anyRunning ? 2 : 0;
+}
+
+
+void printStatistics(const char *name, const SampleStatistics &statistics)
+{
+    std::cout << std::left << std::setw(22) << name << std::right << std::setw(8) << statistics.count;
+    if (statistics.count == 0) {
+        std::cout << std::setw(10) << "-" << "\n";
+        return;
+    }
+    std::cout << std::setw(10) << statistics.mean
+              << "  [" << std::setw(8) << statistics.confidenceLow << ", " << std::setw(8) << statistics.confidenceHigh << "]"
+              << std::setw(10) << statistics.standardDeviation
+              << std::setw(8) << statistics.minimum
+              << std::setw(8) << statistics.maximum << "\n";
+}
+
+// Writes the recorded timings if a profile path was given, failing to write them fails the run
+int saveProfile(const std::string &path, int status)
+{
+    std::string error;
+    if (!path.empty() && !Profiler::saveChromeTrace(path, error)) {
+        std::cerr << "Profile error: " << error << "\n";
+        return 1;
+    }
+    return status;
+}
+
+// Runs the scenario then adds the what-if actions one by one, each run only re-simulates from the last checkpoint
+// before the added action until it reaches the previous run's state again. Prints one row per run
+int runWhatIf(const SimulationConfig &config, int maxSteps, const ActionTable &whatIfActions,
+              const std::vector<std::string> &labels)
+{
+    // Checkpoints are thinned out to SimulationEngine::maxCheckpoints on long runs
+    const int checkpointInterval = 50;
+    IncrementalSimulation simulation(config, checkpointInterval, maxSteps);
+
+    std::cout << std::left << std::setw(28) << "run"
+              << std::right << std::setw(8) << "steps"
+              << std::setw(12) << "completed"
+              << std::setw(12) << "avg wait"
+              << std::setw(12) << "avg ride"
+              << std::setw(10) << "resumed"
+              << std::setw(12) << "simulated"
+              << std::setw(10) << "ms" << "\n"
+              << std::fixed << std::setprecision(1);
+
+    ActionTable actions;
+    actions.append(*config.actions);
+    bool anyRunning = false;
+    for (std::size_t run = 0; run <= whatIfActions.size(); ++run) {
+        auto begin = std::chrono::steady_clock::now();
+        if (run == 0) {
+            simulation.run();
+        } else {
+            actions.append(whatIfActions.at(run - 1));
+            simulation.editActions(std::make_shared<const ActionTable>(actions));
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        const IncrementalSimulation::Outcome &outcome = simulation.getOutcome();
+        const IncrementalSimulation::RunStats &stats = simulation.getLastStats();
+        anyRunning = anyRunning || outcome.running;
+        std::cout << std::left << std::setw(28) << (run == 0 ? std::string("scenario") : "+ " + labels[run - 1])
+                  << std::right << std::setw(8) << outcome.steps
+                  << std::setw(12) << outcome.completedPassengers
+                  << std::setw(12) << outcome.metrics.averageWait()
+                  << std::setw(12) << outcome.metrics.averageRide()
+                  << std::setw(10) << stats.resumedFrom
+                  << std::setw(12) << stats.simulatedSteps
+                  << std::setw(10) << std::chrono::duration<double, std::milli>(end - begin).count() << "\n";
+    }
+    return anyRunning ? 2 : 0;
+}
+
+// Runs independently seeded replications of the scenario and prints the outcome distributions
+int runReplications(const SimulationConfig &config, int maxSteps, int replications, int threads)
+{
+    ReplicationRunner runner(config, maxSteps);
+    runner.setThreadCount(threads);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<ReplicationResult> results = runner.run(replications, config.seed);
+    auto end = std::chrono::steady_clock::now();
+    ReplicationSummary summary = ReplicationRunner::summarize(results);
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    std::cout << "Ran " << summary.replications << " replications on " << runner.getThreadCount()
+              << " threads in " << elapsedMs << " ms (seed " << config.seed << ")\n"
+              << "Completed runs: " << summary.completedRuns << "/" << summary.replications
+              << ", runs with an evacuation: " << summary.evacuations << "\n\n";
+
+    std::cout << std::left << std::setw(22) << "outcome" << std::right << std::setw(8) << "runs"
+              << std::setw(10) << "mean" << "  " << std::setw(20) << "95% CI"
+              << std::setw(10) << "stddev" << std::setw(8) << "min" << std::setw(8) << "max" << "\n"
+              << std::fixed << std::setprecision(2);
+    printStatistics("completion time", summary.completionTime);
+    printStatistics("evacuation time", summary.evacuationTime);
+    printStatistics("passengers completed", summary.completedPassengers);
+    printStatistics("passengers delivered", summary.deliveredPassengers);
+
+    return summary.completedRuns < summary.replications ? 2 : 0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    SimulationConfig config;
+    ActionTable actions;
+    config.passengerCount = 1;
+    config.floorCount = 2;
+    config.elevatorCount = 1;
+    int maxSteps = -1;
+    bool quiet = false;
+    bool compareAll = false;
+    bool seeded = false;
+    int replications = 0;
+    ActionTable whatIfActions;
+    std::vector<std::string> whatIfLabels;
+    std::string saveScenarioPath;
+    std::string saveBinaryPath;
+    int threads = 0;
+    CheckpointOptions checkpoint;
+    LatencyReportOptions latencyReport;
+    std::string passengerReportPath;
+    std::string profilePath;
+    LogFileWriter::Options logFile;
+    SimulationLog::Level logLevel = SimulationLog::Debug;
+    bool categoryEnabled[SimulationLog::CategoryCount] = {true, true, true, true};
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (std::strcmp(arg, "--quiet") == 0) {
+            quiet = true;
+        } else if (std::strcmp(arg, "--log-file-compress") == 0) {
+            logFile.compress = true;
+        } else if (!hasValue) {
+            std::cerr << "Missing value or unknown option: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        } else if (std::strcmp(arg, "--scenario") == 0) {
+            std::string error;
+            if (!ScenarioFile::load(argv[++i], config, error)) {
+                std::cerr << "Invalid scenario " << argv[i] << ": " << error << "\n";
+                return 1;
+            }
+            seeded = true;
+        } else if (std::strcmp(arg, "--save-scenario") == 0) {
+            saveScenarioPath = argv[++i];
+        } else if (std::strcmp(arg, "--binary-scenario") == 0) {
+            std::string error;
+            config.actionStream = MappedScenario::open(argv[++i], error);
+            if (!config.actionStream) {
+                std::cerr << "Invalid binary scenario " << argv[i] << ": " << error << "\n";
+                return 1;
+            }
+            config.actionStream->applyTo(config);
+            seeded = true;
+        } else if (std::strcmp(arg, "--save-binary") == 0) {
+            saveBinaryPath = argv[++i];
+        } else if (std::strcmp(arg, "--passengers") == 0) {
+            config.passengerCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--floors") == 0) {
+            config.floorCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--elevators") == 0) {
+            config.elevatorCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--help-alarm") == 0) {
+            addSafetyEvent(config, SafetyEvent::Help, argv[++i]);
+        } else if (std::strcmp(arg, "--door-obstacle") == 0) {
+            addSafetyEvent(config, SafetyEvent::DoorObstacle, argv[++i]);
+        } else if (std::strcmp(arg, "--fire") == 0) {
+            addSafetyEvent(config, SafetyEvent::Fire, argv[++i]);
+        } else if (std::strcmp(arg, "--overload") == 0) {
+            addSafetyEvent(config, SafetyEvent::Overload, argv[++i]);
+        } else if (std::strcmp(arg, "--power-out") == 0) {
+            addSafetyEvent(config, SafetyEvent::PowerOut, argv[++i]);
+        } else if (std::strcmp(arg, "--floor-travel") == 0) {
+            config.timing.floorTravelSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--acceleration") == 0) {
+            config.timing.accelerationSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--door-dwell") == 0) {
+            config.timing.doorDwellSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--safety-door-hold") == 0) {
+            config.timing.safetyDoorHoldSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--dispatcher") == 0) {
+            const std::string name = argv[++i];
+            compareAll = name == "all";
+            if (!compareAll && !Dispatcher::policyFromName(name, config.dispatchPolicy)) {
+                std::cerr << "Invalid dispatcher: " << name << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if (std::strcmp(arg, "--replications") == 0) {
+            replications = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--what-if") == 0) {
+            if (!parseAction(argv[++i], whatIfActions)) {
+                std::cerr << "Invalid what-if action: " << argv[i] << "\n";
+                return 1;
+            }
+            whatIfLabels.push_back(argv[i]);
+        } else if (std::strcmp(arg, "--max-steps") == 0) {
+            maxSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--checkpoint") == 0) {
+            checkpoint.savePath = argv[++i];
+        } else if (std::strcmp(arg, "--checkpoint-every") == 0) {
+            checkpoint.interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--resume") == 0) {
+            checkpoint.resumePath = argv[++i];
+        } else if (std::strcmp(arg, "--latency-report") == 0) {
+            latencyReport.path = argv[++i];
+        } else if (std::strcmp(arg, "--latency-every") == 0) {
+            latencyReport.interval = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--passenger-report") == 0) {
+            passengerReportPath = argv[++i];
+        } else if (std::strcmp(arg, "--profile") == 0) {
+            profilePath = argv[++i];
+        } else if (std::strcmp(arg, "--log-file") == 0) {
+            logFile.path = argv[++i];
+        } else if (std::strcmp(arg, "--log-file-size") == 0) {
+            logFile.maxFileBytes = std::strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (std::strcmp(arg, "--log-file-keep") == 0) {
+            logFile.maxFiles = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--log-file-overflow") == 0) {
+            const std::string policy = argv[++i];
+            if (policy != "drop" && policy != "block") {
+                std::cerr << "Invalid log file overflow policy: " << policy << "\n";
+                return 1;
+            }
+            logFile.overflow = policy == "block" ? LogFileWriter::Block : LogFileWriter::DropLowSeverity;
+        } else if (std::strcmp(arg, "--log-level") == 0) {
+            if (!parseLevel(argv[++i], logLevel)) {
+                std::cerr << "Invalid log level: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--log-categories") == 0) {
+            if (!parseCategories(argv[++i], categoryEnabled)) {
+                std::cerr << "Invalid log categories: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (std::strcmp(arg, "--action") == 0) {
+            if (!parseAction(argv[++i], actions)) {
+                std::cerr << "Invalid action: " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // --action options add to the actions of the scenario file
+    if (!config.actions->isEmpty()) {
+        ActionTable combined;
+        combined.reserve(config.actions->size() + actions.size());
+        combined.append(*config.actions);
+        combined.append(actions);
+        actions = std::move(combined);
+    }
+    config.actions = std::make_shared<const ActionTable>(std::move(actions));
+
+    if (!seeded) {
+        config.seed = static_cast<std::uint64_t>(std::time(nullptr));
+    }
+
+    std::string configError;
+    if (!config.validate(configError)) {
+        std::cerr << "Invalid scenario: " << configError << "\n";
+        return 1;
+    }
+
+    if (!saveScenarioPath.empty()) {
+        std::string error;
+        if (!ScenarioFile::save(saveScenarioPath, config, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::cout << "Saved " << config.actions->size() << " actions to " << saveScenarioPath << "\n";
+        return 0;
+    }
+    if (!saveBinaryPath.empty()) {
+        std::string error;
+        if (!MappedScenario::write(saveBinaryPath, config, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        std::cout << "Saved " << config.actions->size() << " actions to " << saveBinaryPath << "\n";
+        return 0;
+    }
+
+    Profiler::setEnabled(!profilePath.empty());
+    if (replications > 0) {
+        return saveProfile(profilePath, runReplications(config, maxSteps, replications, threads));
+    }
+    if (compareAll) {
+        return saveProfile(profilePath, comparePolicies(config, maxSteps));
+    }
+    if (!whatIfActions.isEmpty()) {
+        return saveProfile(profilePath, runWhatIf(config, maxSteps, whatIfActions, whatIfLabels));
+    }
+
+    LogFileWriter logFileWriter;
+    if (!logFile.path.empty()) {
+        std::string error;
+        if (!logFileWriter.open(logFile, error)) {
+            std::cerr << "Log file error: " << error << "\n";
+            return 1;
+        }
+    }
+
+    SimulationEngine::LogSink sink;
+    if (!quiet && logFileWriter.isOpen()) {
+        sink = [&logFileWriter](SimulationLog::Category category, SimulationLog::Level level,
+                                const std::string &message, const SimulationLog::Subject &) {
+            std::cout << message << '\n';
+            logFileWriter.write(category, level, message);
+        };
+    } else if (!quiet) {
+        sink = [](SimulationLog::Category, SimulationLog::Level, const std::string &message,
+                  const SimulationLog::Subject &) {
+            std::cout << message << '\n';
+        };
+    } else if (logFileWriter.isOpen()) {
+        sink = [&logFileWriter](SimulationLog::Category category, SimulationLog::Level level,
+                                const std::string &message, const SimulationLog::Subject &) {
+            logFileWriter.write(category, level, message);
+        };
+    }
+
+    LogFilter filter(logLevel);
+    for (int i = 0; i < SimulationLog::CategoryCount; ++i) {
+        if (!categoryEnabled[i]) {
+            filter.setCategoryEnabled(static_cast<SimulationLog::Category>(i), false);
+        }
+    }
+
+    RunResult result = runSimulation(config, sink, filter, maxSteps, checkpoint, latencyReport,
+                                     passengerReportPath);
+    std::string logFileError;
+    const bool logFileClosed = logFileWriter.close(logFileError);
+    if (!result.error.empty()) {
+        std::cerr << result.error << "\n";
+        return 1;
+    }
+    if (!logFileClosed) {
+        std::cerr << "Log file error: " << logFileError << "\n";
+        return 1;
+    }
+    std::cout << "Simulated " << result.steps << " time steps in " << result.elapsedMs << " ms\n"
+              << "Completed passengers: " << result.completedPassengers << "/" << config.passengerCount << "\n";
+    if (!latencyReport.path.empty()) {
+        for (const std::string &line : result.metrics.latency.summary()) {
+            std::cout << line << "\n";
+        }
+    }
+    if (!logFile.path.empty()) {
+        std::cout << "Log file: " << logFileWriter.getWrittenCount() << " lines written, "
+                  << logFileWriter.getDroppedCount() << " dropped, " << logFileWriter.getRotationCount()
+                  << " rotations\n";
+    }
+
+    return saveProfile(profilePath, result.running ? 2 : 0);
+}
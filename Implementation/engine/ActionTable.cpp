@@ -0,0 +1,93 @@
+#include "ActionTable.h"
+
+void ActionTable::reserve(std::size_t count)
+{
+    timeSteps.reserve(count);
+    floors.reserve(count);
+    passengerIds.reserve(count);
+    types.reserve(count);
+}
+
+void ActionTable::append(const PassengerAction &action)
+{
+    timeSteps.push_back(action.timeStep);
+    floors.push_back(action.floor);
+    passengerIds.push_back(action.passengerId);
+    types.push_back(action.actionType);
+}
+
+void ActionTable::append(const ActionTable &other)
+{
+    timeSteps.insert(timeSteps.end(), other.timeSteps.begin(), other.timeSteps.end());
+    floors.insert(floors.end(), other.floors.begin(), other.floors.end());
+    passengerIds.insert(passengerIds.end(), other.passengerIds.begin(), other.passengerIds.end());
+    types.insert(types.end(), other.types.begin(), other.types.end());
+}
+
+void ActionTable::replace(std::size_t index, const PassengerAction &action)
+{
+    timeSteps[index] = action.timeStep;
+    floors[index] = action.floor;
+    passengerIds[index] = action.passengerId;
+    types[index] = action.actionType;
+}
+
+void ActionTable::clear()
+{
+    timeSteps.clear();
+    floors.clear();
+    passengerIds.clear();
+    types.clear();
+}
+
+/**
+ * @brief Branch-free count over the type column, compiles to SIMD compares at -O2/-O3
+ */
+std::size_t ActionTable::countOfType(PassengerAction::Type type) const
+{
+    const std::uint8_t *column = types.data();
+    const std::size_t count = types.size();
+    const std::uint8_t wanted = type;
+
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        matches += column[i] == wanted;
+    }
+    return matches;
+}
+
+void ActionTable::selectType(PassengerAction::Type type, std::vector<std::uint32_t> &indices) const
+{
+    const std::uint8_t *column = types.data();
+    const std::size_t count = types.size();
+    const std::uint8_t wanted = type;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (column[i] == wanted) {
+            indices.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+/**
+ * @brief Branch-free count over the time step column
+ */
+std::size_t ActionTable::countInTimeRange(int firstTimeStep, int lastTimeStep) const
+{
+    const std::int32_t *column = timeSteps.data();
+    const std::size_t count = timeSteps.size();
+
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        matches += (column[i] >= firstTimeStep) & (column[i] <= lastTimeStep);
+    }
+    return matches;
+}
+
+std::size_t ActionTable::memoryUsage() const
+{
+    return timeSteps.capacity() * sizeof(std::int32_t)
+         + floors.capacity() * sizeof(std::int32_t)
+         + passengerIds.capacity() * sizeof(std::int32_t)
+         + types.capacity() * sizeof(std::uint8_t);
+}
@@ -0,0 +1,63 @@
+#ifndef ACTIONTABLE_H
+#define ACTIONTABLE_H
+
+#include "PassengerAction.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The ActionTable class is responsible for:
+ *        - Storing the scenario's passenger actions as one array per field (struct of arrays)
+ *        - Handing out single actions as 16 byte PassengerAction records
+ *        - Scanning a single field of every action, e.g. counting or selecting actions of one type
+ *        A field scan only streams that field's array, so it stays cache friendly and
+ *        auto-vectorizes even with tens of millions of actions
+ */
+class ActionTable
+{
+public:
+    void reserve(std::size_t count);
+    void append(const PassengerAction &action);
+    void append(const ActionTable &other);
+    // Overwrites the action at index, e.g. an edit of a published scenario made on a copy of its table
+    void replace(std::size_t index, const PassengerAction &action);
+    void clear();
+
+    std::size_t size() const { return timeSteps.size(); }
+    bool isEmpty() const { return timeSteps.empty(); }
+
+    PassengerAction at(std::size_t index) const {
+        return PassengerAction(static_cast<PassengerAction::Type>(types[index]),
+                               floors[index], timeSteps[index], passengerIds[index]);
+    }
+
+    int timeStepAt(std::size_t index) const { return timeSteps[index]; }
+    PassengerAction::Type typeAt(std::size_t index) const { return static_cast<PassengerAction::Type>(types[index]); }
+
+    // Column access for bulk scans
+    const std::vector<std::int32_t> &getTimeSteps() const { return timeSteps; }
+    const std::vector<std::int32_t> &getFloors() const { return floors; }
+    const std::vector<std::int32_t> &getPassengerIds() const { return passengerIds; }
+    const std::vector<std::uint8_t> &getTypes() const { return types; }
+
+    // Number of actions of the given type
+    std::size_t countOfType(PassengerAction::Type type) const;
+
+    // Appends the indices of the actions of the given type to indices
+    void selectType(PassengerAction::Type type, std::vector<std::uint32_t> &indices) const;
+
+    // Number of actions scheduled in [firstTimeStep, lastTimeStep]
+    std::size_t countInTimeRange(int firstTimeStep, int lastTimeStep) const;
+
+    // Bytes held by the table's arrays
+    std::size_t memoryUsage() const;
+
+private:
+    std::vector<std::int32_t> timeSteps;
+    std::vector<std::int32_t> floors;
+    std::vector<std::int32_t> passengerIds;
+    std::vector<std::uint8_t> types;
+};
+
+#endif // ACTIONTABLE_H
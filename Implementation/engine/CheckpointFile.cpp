@@ -0,0 +1,701 @@
+#include "CheckpointFile.h"
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+namespace {
+
+const char fileMagic[8] = {'E', 'L', 'V', 'S', 'T', 'A', 'T', 'E'};
+const std::uint32_t fileVersion = 7;
+
+// Upper bound on any count read from a stream whose size is unknown
+const std::uint64_t maxCount = std::uint64_t(1) << 32;
+
+// The configuration a state belongs to
+struct ConfigFingerprint {
+    std::uint64_t seed;
+    std::int32_t passengerCount;
+    std::int32_t floorCount;
+    std::int32_t elevatorCount;
+    std::int32_t dispatchPolicy;
+    std::uint64_t streamSize;
+    std::uint64_t safetyEventCount;
+    std::int32_t timing[4];
+
+    explicit ConfigFingerprint(const SimulationConfig &config)
+        : seed(config.seed),
+          passengerCount(config.passengerCount),
+          floorCount(config.floorCount),
+          elevatorCount(config.elevatorCount),
+          dispatchPolicy(config.dispatchPolicy),
+          streamSize(config.actionStream ? config.actionStream->size() : 0),
+          safetyEventCount(config.safetyEvents.size()),
+          timing{config.timing.floorTravelSteps, config.timing.accelerationSteps, config.timing.doorDwellSteps,
+                 config.timing.safetyDoorHoldSteps} {}
+};
+
+class StateWriter
+{
+public:
+    explicit StateWriter(std::ostream &out) : out(out) {}
+
+    template <typename Value>
+    void value(Value value) {
+        static_assert(std::is_arithmetic<Value>::value, "only numbers are written as is");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void ints(const std::vector<int> &values) {
+        value<std::uint64_t>(values.size());
+        for (int entry : values) {
+            value<std::int32_t>(entry);
+        }
+    }
+
+private:
+    std::ostream &out;
+};
+
+class StateReader
+{
+public:
+    explicit StateReader(std::istream &in) : in(in), end(endOf(in)) {}
+
+    template <typename Value>
+    Value value() {
+        Value value = Value();
+        in.read(reinterpret_cast<char *>(&value), sizeof(value));
+        return value;
+    }
+
+    // Reads a count of entries taking at least entryBytes each in the file, and fails on counts the rest of the
+    // file cannot hold, so a corrupt count fails instead of exhausting memory
+    std::size_t count(std::size_t entryBytes) {
+        std::uint64_t count = value<std::uint64_t>();
+        if (!in || count > bytesLeft() / entryBytes) {
+            in.setstate(std::ios::failbit);
+            return 0;
+        }
+        return static_cast<std::size_t>(count);
+    }
+
+    // Reads a position in a list of the configuration, checked by the caller
+    std::size_t position() {
+        return static_cast<std::size_t>(std::min<std::uint64_t>(value<std::uint64_t>(), SIZE_MAX));
+    }
+
+    void ints(std::vector<int> &values) {
+        values.resize(count(sizeof(std::int32_t)));
+        for (int &entry : values) {
+            entry = value<std::int32_t>();
+        }
+    }
+
+    bool good() const { return static_cast<bool>(in); }
+    void fail() { in.setstate(std::ios::failbit); }
+
+private:
+    static std::streamoff endOf(std::istream &in) {
+        const std::istream::pos_type start = in.tellg();
+        if (start == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+            in.clear();
+            return -1;
+        }
+        const std::streamoff end = in.tellg();
+        in.seekg(start);
+        return end;
+    }
+
+    std::uint64_t bytesLeft() {
+        const std::istream::pos_type current = in.tellg();
+        if (end < 0 || current == std::istream::pos_type(-1)) {
+            return maxCount;
+        }
+        return end > std::streamoff(current) ? static_cast<std::uint64_t>(end - std::streamoff(current)) : 0;
+    }
+
+    std::istream &in;
+    const std::streamoff end;   // Size of the stream, -1 if it cannot seek
+};
+
+void writeCar(StateWriter &writer, const ElevatorCar &car)
+{
+    writer.value<std::int32_t>(car.id);
+    writer.value<std::int32_t>(car.floor);
+    writer.value<std::int32_t>(car.state);
+    writer.value<std::int32_t>(car.direction);
+    writer.value<std::int32_t>(car.passengersAssigned);
+    writer.value<std::int32_t>(car.readyTimeStep);
+    writer.value<std::int32_t>(car.trip.carId);
+    writer.value<std::int32_t>(car.trip.fromFloor);
+    writer.value<std::int32_t>(car.trip.toFloor);
+    writer.value<std::int32_t>(car.trip.startTimeStep);
+    writer.value<std::int32_t>(car.trip.firstFloorTimeStep);
+    writer.value<std::int32_t>(car.trip.floorTravelSteps);
+    writer.value<std::int32_t>(car.trip.endTimeStep);
+
+    writer.value<std::uint64_t>(car.stops.size());
+    for (int stop : car.stops) {
+        writer.value<std::int32_t>(stop);
+    }
+    writer.value<std::uint64_t>(car.waitingByFloor.size());
+    for (std::size_t floor = 0; floor < car.waitingByFloor.size(); ++floor) {
+        writer.ints(car.waitingByFloor[floor]);
+        writer.ints(car.ridingByFloor[floor]);
+    }
+}
+
+// Fails unless the car has floorSlots passenger lists, one per floor of the building plus the unused floor 0
+void readCar(StateReader &reader, std::size_t floorSlots, ElevatorCar &car)
+{
+    car.id = reader.value<std::int32_t>();
+    car.floor = reader.value<std::int32_t>();
+    const int state = reader.value<std::int32_t>();
+    const int direction = reader.value<std::int32_t>();
+    if (state < ElevatorCar::Idle || state > ElevatorCar::Stopped || direction < ElevatorCar::Down
+        || direction > ElevatorCar::Up) {
+        reader.fail();
+        return;
+    }
+    car.state = static_cast<ElevatorCar::State>(state);
+    car.direction = static_cast<ElevatorCar::Direction>(direction);
+    car.passengersAssigned = reader.value<std::int32_t>();
+    car.readyTimeStep = reader.value<std::int32_t>();
+    car.trip.carId = reader.value<std::int32_t>();
+    car.trip.fromFloor = reader.value<std::int32_t>();
+    car.trip.toFloor = reader.value<std::int32_t>();
+    car.trip.startTimeStep = reader.value<std::int32_t>();
+    car.trip.firstFloorTimeStep = reader.value<std::int32_t>();
+    car.trip.floorTravelSteps = reader.value<std::int32_t>();
+    car.trip.endTimeStep = reader.value<std::int32_t>();
+    if (car.trip.floorTravelSteps < 1) {
+        reader.fail();
+    }
+
+    car.stops.clear();
+    for (std::size_t i = reader.count(sizeof(std::int32_t)); i > 0 && reader.good(); --i) {
+        car.stops.insert(reader.value<std::int32_t>());
+    }
+    if (reader.value<std::uint64_t>() != floorSlots) {
+        reader.fail();
+        return;
+    }
+    car.waitingByFloor.assign(floorSlots, std::vector<int>());
+    car.ridingByFloor.assign(floorSlots, std::vector<int>());
+    for (std::size_t floor = 0; floor < floorSlots && reader.good(); ++floor) {
+        reader.ints(car.waitingByFloor[floor]);
+        reader.ints(car.ridingByFloor[floor]);
+    }
+}
+
+void writeJourney(StateWriter &writer, const PassengerJourney &journey)
+{
+    writer.value<std::int32_t>(journey.passengerId);
+    writer.value<std::int32_t>(journey.origin);
+    writer.value<std::int32_t>(journey.destination);
+    writer.value<std::int32_t>(journey.car);
+    writer.value<std::int32_t>(journey.state);
+    writer.value<std::int32_t>(journey.requestTimeStep);
+    writer.value<std::int32_t>(journey.boardTimeStep);
+    writer.value<std::int32_t>(journey.exitTimeStep);
+}
+
+void readJourney(StateReader &reader, PassengerJourney &journey)
+{
+    journey.passengerId = reader.value<std::int32_t>();
+    journey.origin = reader.value<std::int32_t>();
+    journey.destination = reader.value<std::int32_t>();
+    journey.car = reader.value<std::int32_t>();
+    const int state = reader.value<std::int32_t>();
+    if (state < PassengerJourney::Waiting || state > PassengerJourney::Done) {
+        reader.fail();
+        return;
+    }
+    journey.state = static_cast<PassengerJourney::State>(state);
+    journey.requestTimeStep = reader.value<std::int32_t>();
+    journey.boardTimeStep = reader.value<std::int32_t>();
+    journey.exitTimeStep = reader.value<std::int32_t>();
+}
+
+// Only the passengers that requested a car are written
+void writePassengers(StateWriter &writer, const PassengerTable &passengers)
+{
+    std::uint64_t count = 0;
+    for (std::size_t id = 1; id < passengers.size(); ++id) {
+        count += passengers.stateOf(static_cast<int>(id)) != PassengerTable::Absent;
+    }
+    writer.value(count);
+    for (std::size_t id = 1; id < passengers.size(); ++id) {
+        const int passengerId = static_cast<int>(id);
+        if (passengers.stateOf(passengerId) == PassengerTable::Absent) {
+            continue;
+        }
+        writer.value<std::int32_t>(passengerId);
+        writer.value<std::uint8_t>(passengers.stateOf(passengerId));
+        writer.value<std::uint8_t>(passengers.isCompleted(passengerId));
+        writer.value<std::int32_t>(passengers.originOf(passengerId));
+        writer.value<std::int32_t>(passengers.destinationOf(passengerId));
+        writer.value<std::int32_t>(passengers.carOf(passengerId));
+        writer.value<std::int32_t>(passengers.requestTimeStepOf(passengerId));
+        writer.value<std::int32_t>(passengers.boardTimeStepOf(passengerId));
+        writer.value<std::int32_t>(passengers.exitTimeStepOf(passengerId));
+    }
+}
+
+void readPassengers(StateReader &reader, PassengerTable &passengers)
+{
+    passengers.clear();
+    for (std::size_t i = reader.count(30); i > 0 && reader.good(); --i) {
+        const int passengerId = reader.value<std::int32_t>();
+        const std::uint8_t state = reader.value<std::uint8_t>();
+        const bool completed = reader.value<std::uint8_t>() != 0;
+        const int origin = reader.value<std::int32_t>();
+        const int destination = reader.value<std::int32_t>();
+        const int car = reader.value<std::int32_t>();
+        const int requestTimeStep = reader.value<std::int32_t>();
+        const int boardTimeStep = reader.value<std::int32_t>();
+        const int exitTimeStep = reader.value<std::int32_t>();
+        const PassengerTable::State rowState = static_cast<PassengerTable::State>(
+            std::min<std::uint8_t>(state, PassengerTable::Done));
+        passengers.assign(passengerId, rowState, completed, origin, destination, car,
+                          requestTimeStep, boardTimeStep, exitTimeStep);
+    }
+}
+
+void writeMetrics(StateWriter &writer, const SimulationMetrics &metrics)
+{
+    writer.value<std::int32_t>(metrics.journeysRequested);
+    writer.value<std::int32_t>(metrics.journeysCompleted);
+    writer.value<std::int64_t>(metrics.totalWaitSteps);
+    writer.value<std::int64_t>(metrics.totalRideSteps);
+    writer.value<std::int32_t>(metrics.timeSteps);
+    writer.value<std::int32_t>(metrics.evacuationStartTimeStep);
+
+    // Histograms with a value, each as (scope, key, kind) then its buckets
+    const LatencyMetrics &latency = metrics.latency;
+    std::vector<std::array<int, 3>> recorded;
+    for (LatencyMetrics::Scope scope : {LatencyMetrics::All, LatencyMetrics::Floor, LatencyMetrics::Car}) {
+        for (std::size_t key = 0; key < latency.keyCount(scope); ++key) {
+            for (int kind = 0; kind < LatencyMetrics::KindCount; ++kind) {
+                if (latency.histogram(scope, static_cast<int>(key), LatencyMetrics::Kind(kind)).count() > 0) {
+                    recorded.push_back({scope, static_cast<int>(key), kind});
+                }
+            }
+        }
+    }
+    writer.value<std::uint64_t>(recorded.size());
+    for (const std::array<int, 3> &entry : recorded) {
+        const LatencyHistogram &histogram = latency.histogram(LatencyMetrics::Scope(entry[0]), entry[1],
+                                                              LatencyMetrics::Kind(entry[2]));
+        writer.value<std::int32_t>(entry[0]);
+        writer.value<std::int32_t>(entry[1]);
+        writer.value<std::int32_t>(entry[2]);
+        writer.value<std::uint64_t>(histogram.getSum());
+        writer.value<std::int32_t>(histogram.max());
+        writer.value<std::uint64_t>(histogram.getBuckets().size());
+        for (std::uint64_t count : histogram.getBuckets()) {
+            writer.value(count);
+        }
+    }
+}
+
+void readMetrics(StateReader &reader, SimulationMetrics &metrics)
+{
+    metrics.journeysRequested = reader.value<std::int32_t>();
+    metrics.journeysCompleted = reader.value<std::int32_t>();
+    metrics.totalWaitSteps = reader.value<std::int64_t>();
+    metrics.totalRideSteps = reader.value<std::int64_t>();
+    metrics.timeSteps = reader.value<std::int32_t>();
+    metrics.evacuationStartTimeStep = reader.value<std::int32_t>();
+
+    metrics.latency = LatencyMetrics();
+    const std::size_t histogramCount = reader.count(32);
+    const std::size_t maxBuckets = LatencyHistogram::bucketOf(INT_MAX) + 1;
+    for (std::size_t i = 0; i < histogramCount && reader.good(); ++i) {
+        const int scope = reader.value<std::int32_t>();
+        const int key = reader.value<std::int32_t>();
+        const int kind = reader.value<std::int32_t>();
+        const std::uint64_t sum = reader.value<std::uint64_t>();
+        const int maximum = reader.value<std::int32_t>();
+        const std::size_t bucketCount = reader.count(sizeof(std::uint64_t));
+        if (bucketCount > maxBuckets) {
+            reader.fail();
+            return;
+        }
+        std::vector<std::uint64_t> buckets(bucketCount);
+        for (std::uint64_t &count : buckets) {
+            count = reader.value<std::uint64_t>();
+        }
+        // Keys are floor numbers and car IDs, a corrupt one is dropped instead of growing the metrics
+        if (scope < LatencyMetrics::All || scope > LatencyMetrics::Car || kind < 0 || kind >= LatencyMetrics::KindCount
+            || key < 0 || key > 1 << 16) {
+            continue;
+        }
+        LatencyHistogram histogram;
+        histogram.assign(buckets, sum, maximum);
+        metrics.latency.assign(LatencyMetrics::Scope(scope), key, LatencyMetrics::Kind(kind), histogram);
+    }
+}
+
+bool isFloor(const SimulationConfig &config, int floor)
+{
+    return floor >= 1 && floor <= std::max(1, config.floorCount);
+}
+
+// Lists journeyIndex, false if it is no journey slot or was listed before
+bool listJourney(std::vector<bool> &listed, int journeyIndex)
+{
+    if (journeyIndex < 0 || static_cast<std::size_t>(journeyIndex) >= listed.size() || listed[journeyIndex]) {
+        return false;
+    }
+    listed[journeyIndex] = true;
+    return true;
+}
+
+/**
+ * @brief Checks every floor, car and journey index the engine follows from the cars and journeys, and that the run
+ *        can end: each journey is either in progress, listed once by its car at a floor the car stops at, or done
+ *        and in a free slot, and the counts of requested and completed journeys agree with them
+ */
+bool validCarsAndJourneys(const SimulationConfig &config, const SimulationState &state, std::string &error)
+{
+    const CarTiming &timing = config.timing;
+    // Longest a car takes to reach its next stop or close its doors
+    const std::int64_t maxCarDelay = 2 * std::int64_t(timing.accelerationSteps)
+                                   + std::int64_t(std::max(1, config.floorCount)) * timing.floorTravelSteps
+                                   + timing.doorDwellSteps;
+    std::vector<bool> listed(state.journeys.size());
+    std::int64_t inProgress = 0;
+
+    for (std::size_t carIndex = 0; carIndex < state.cars.size(); ++carIndex) {
+        const ElevatorCar &car = state.cars[carIndex];
+        const MovementSegment &trip = car.trip;
+        const int carId = static_cast<int>(carIndex);
+        bool valid = car.id == carId + 1 && isFloor(config, car.floor)
+                     && isFloor(config, trip.fromFloor) && isFloor(config, trip.toFloor)
+                     && car.readyTimeStep - std::int64_t(state.currentTimeStep) <= maxCarDelay
+                     && car.waitingByFloor[0].empty() && car.ridingByFloor[0].empty();
+        if (car.state == ElevatorCar::Moving) {
+            valid = valid && trip.fromFloor != trip.toFloor && trip.toFloor == car.floor && trip.startTimeStep >= 0
+                    && trip.startTimeStep <= trip.firstFloorTimeStep && trip.firstFloorTimeStep <= trip.endTimeStep
+                    && trip.endTimeStep == car.readyTimeStep;
+        }
+        for (int stop : car.stops) {
+            valid = valid && isFloor(config, stop);
+        }
+        int assigned = 0;
+        for (int floor = 1; valid && floor < static_cast<int>(car.waitingByFloor.size()); ++floor) {
+            const std::vector<int> &waiting = car.waitingByFloor[floor];
+            const std::vector<int> &riding = car.ridingByFloor[floor];
+            valid = (waiting.empty() && riding.empty()) || car.stops.count(floor);
+            for (int journeyIndex : waiting) {
+                valid = valid && listJourney(listed, journeyIndex);
+                const PassengerJourney *journey = valid ? &state.journeys[journeyIndex] : nullptr;
+                valid = valid && journey->state == PassengerJourney::Waiting && journey->car == carId
+                        && journey->origin == floor;
+            }
+            for (int journeyIndex : riding) {
+                valid = valid && listJourney(listed, journeyIndex);
+                const PassengerJourney *journey = valid ? &state.journeys[journeyIndex] : nullptr;
+                valid = valid && journey->state == PassengerJourney::Riding && journey->car == carId
+                        && journey->destination == floor;
+            }
+            assigned += static_cast<int>(waiting.size() + riding.size());
+        }
+        if (!valid || car.passengersAssigned != assigned) {
+            error = "invalid car " + std::to_string(carIndex + 1);
+            return false;
+        }
+        inProgress += assigned;
+    }
+
+    bool valid = true;
+    for (int journeyIndex : state.freeJourneySlots) {
+        valid = valid && listJourney(listed, journeyIndex)
+                && state.journeys[journeyIndex].state == PassengerJourney::Done;
+    }
+    for (std::size_t journeyIndex = 0; journeyIndex < state.journeys.size(); ++journeyIndex) {
+        const PassengerJourney &journey = state.journeys[journeyIndex];
+        valid = valid && listed[journeyIndex] && isFloor(config, journey.origin)
+                && isFloor(config, journey.destination) && journey.car >= 0
+                && static_cast<std::size_t>(journey.car) < state.cars.size();
+    }
+    if (!valid) {
+        error = "invalid journey";
+        return false;
+    }
+
+    const SimulationMetrics &metrics = state.metrics;
+    const int passengerCount = std::max(0, config.passengerCount);
+    if (state.currentTimeStep < 0 || metrics.journeysCompleted < 0
+        || std::int64_t(metrics.journeysRequested) - metrics.journeysCompleted != inProgress
+        || state.completedPassengers < std::min(passengerCount, metrics.journeysCompleted)
+        || state.completedPassengers > passengerCount) {
+        error = "invalid passenger counts";
+        return false;
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief Writes the configuration fingerprint then every field of the state, numbers in the machine's byte order
+ */
+bool CheckpointFile::write(std::ostream &out, const SimulationConfig &config, const SimulationState &state)
+{
+    StateWriter writer(out);
+    const ConfigFingerprint fingerprint(config);
+
+    out.write(fileMagic, sizeof(fileMagic));
+    writer.value(fileVersion);
+    writer.value(fingerprint.seed);
+    writer.value(fingerprint.passengerCount);
+    writer.value(fingerprint.floorCount);
+    writer.value(fingerprint.elevatorCount);
+    writer.value(fingerprint.dispatchPolicy);
+    writer.value(fingerprint.streamSize);
+    writer.value(fingerprint.safetyEventCount);
+    for (std::int32_t steps : fingerprint.timing) {
+        writer.value(steps);
+    }
+    writer.value<std::uint64_t>(state.knownActionCount());
+
+    writer.value<std::uint8_t>(state.simulationRunning);
+    writer.value<std::int32_t>(state.currentTimeStep);
+    writer.value<std::int32_t>(state.completedPassengers);
+    writer.value<std::int32_t>(state.randomPassengerBase);
+
+    // The calendar is rebuilt from the actions, only its position is stored
+    writer.value<std::uint64_t>(state.calendar.getBuiltCount());
+    writer.value<std::uint64_t>(state.calendar.getCursor());
+    writer.value<std::int32_t>(state.calendar.getNextSequence());
+    writer.value<std::uint64_t>(state.calendar.getScheduled().size());
+    for (const EventCalendar::Entry &entry : state.calendar.getScheduled()) {
+        writer.value<std::int32_t>(entry.timeStep);
+        writer.value<std::int32_t>(entry.sequence);
+        writer.value<std::int32_t>(entry.actionIndex);
+    }
+    // Safety events are only built at start, the cursor is their whole position
+    writer.value<std::uint64_t>(state.safetyCalendar.getCursor());
+    writer.ints(state.safetyDoorsClosing);
+
+    writer.value<std::uint64_t>(state.randomStreams.size());
+    for (const RandomStream &stream : state.randomStreams) {
+        writer.value(stream.position());
+    }
+
+    writer.value(state.streamCursor);
+    writer.value(state.streamReleased);
+
+    writer.value<std::uint64_t>(state.cars.size());
+    for (const ElevatorCar &car : state.cars) {
+        writeCar(writer, car);
+    }
+    writer.value<std::uint64_t>(state.journeys.size());
+    for (const PassengerJourney &journey : state.journeys) {
+        writeJourney(writer, journey);
+    }
+    writer.ints(state.freeJourneySlots);
+    writePassengers(writer, state.passengers);
+    writeMetrics(writer, state.metrics);
+
+    const ExitActionIndex &exitActions = state.exitActions;
+    writer.value<std::uint64_t>(exitActions.passengerCount());
+    for (std::size_t slot = 0; slot < exitActions.passengerCount(); ++slot) {
+        writer.value<std::int32_t>(exitActions.passengerAt(slot));
+        writer.value<std::int32_t>(exitActions.usedAt(slot));
+        writer.ints(exitActions.exitsAt(slot));
+    }
+    // Eight flags per byte
+    std::uint8_t flags = 0;
+    for (std::size_t i = 0; i < state.exitActionPaired.size(); ++i) {
+        flags |= static_cast<std::uint8_t>(state.exitActionPaired[i]) << (i % 8);
+        if (i % 8 == 7 || i + 1 == state.exitActionPaired.size()) {
+            writer.value(flags);
+            flags = 0;
+        }
+    }
+
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Reads the state into a copy and replaces state only once the whole file was read
+ */
+bool CheckpointFile::read(std::istream &in, const SimulationConfig &config, SimulationState &state,
+                          std::string &error)
+{
+    StateReader reader(in);
+    const ConfigFingerprint expected(config);
+
+    char magic[sizeof(fileMagic)] = {};
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, fileMagic, sizeof(fileMagic)) != 0) {
+        error = "not a checkpoint file";
+        return false;
+    }
+    if (reader.value<std::uint32_t>() != fileVersion) {
+        error = "unsupported checkpoint version";
+        return false;
+    }
+    if (reader.value<std::uint64_t>() != expected.seed ||
+        reader.value<std::int32_t>() != expected.passengerCount ||
+        reader.value<std::int32_t>() != expected.floorCount ||
+        reader.value<std::int32_t>() != expected.elevatorCount ||
+        reader.value<std::int32_t>() != expected.dispatchPolicy ||
+        reader.value<std::uint64_t>() != expected.streamSize ||
+        reader.value<std::uint64_t>() != expected.safetyEventCount) {
+        error = "the checkpoint was saved from another scenario";
+        return false;
+    }
+    for (std::int32_t steps : expected.timing) {
+        if (reader.value<std::int32_t>() != steps) {
+            error = "the checkpoint was saved with other car timing";
+            return false;
+        }
+    }
+    const std::size_t knownActionCount = reader.position();
+    if (knownActionCount > config.actions->size()) {
+        error = "the checkpoint was saved from another scenario";
+        return false;
+    }
+
+    SimulationState loaded;
+    loaded.simulationRunning = reader.value<std::uint8_t>() != 0;
+    loaded.currentTimeStep = reader.value<std::int32_t>();
+    loaded.completedPassengers = reader.value<std::int32_t>();
+    loaded.randomPassengerBase = reader.value<std::int32_t>();
+
+    const std::size_t builtCount = reader.position();
+    const std::size_t cursor = reader.position();
+    const int nextSequence = reader.value<std::int32_t>();
+    std::vector<EventCalendar::Entry> scheduled(reader.count(sizeof(std::int32_t) * 3));
+    for (EventCalendar::Entry &entry : scheduled) {
+        entry.timeStep = reader.value<std::int32_t>();
+        entry.sequence = reader.value<std::int32_t>();
+        entry.actionIndex = reader.value<std::int32_t>();
+    }
+    const std::size_t safetyCursor = reader.position();
+    reader.ints(loaded.safetyDoorsClosing);
+    bool validCalendar = builtCount <= knownActionCount && cursor <= builtCount &&
+                         safetyCursor <= config.safetyEvents.size();
+    for (const EventCalendar::Entry &entry : scheduled) {
+        validCalendar = validCalendar && entry.actionIndex >= 0
+                        && static_cast<std::size_t>(entry.actionIndex) < knownActionCount;
+    }
+    if (!validCalendar) {
+        error = "invalid calendar";
+        return false;
+    }
+    loaded.calendar.build(*config.actions, builtCount);
+    loaded.calendar.restore(cursor, scheduled, nextSequence);
+    const std::vector<std::int32_t> safetyTimeSteps = SafetyEvent::timeSteps(config.safetyEvents);
+    loaded.safetyCalendar.build(safetyTimeSteps, safetyTimeSteps.size());
+    loaded.safetyCalendar.restore(safetyCursor, std::vector<EventCalendar::Entry>(),
+                                  static_cast<int>(safetyTimeSteps.size()));
+
+    const std::size_t streamCount = reader.count(sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < streamCount && reader.good(); ++i) {
+        loaded.randomStreams.emplace_back(config.seed, i);
+        loaded.randomStreams.back().seek(reader.value<std::uint64_t>());
+    }
+
+    loaded.streamCursor = reader.value<std::uint64_t>();
+    loaded.streamReleased = reader.value<std::uint64_t>();
+
+    const std::size_t carCount = static_cast<std::size_t>(std::max(1, config.elevatorCount));
+    const std::size_t floorSlots = static_cast<std::size_t>(std::max(1, config.floorCount)) + 1;
+    if (reader.good() && reader.value<std::uint64_t>() != carCount) {
+        error = "invalid car";
+        return false;
+    }
+    loaded.cars.resize(carCount);
+    for (std::size_t i = 0; i < loaded.cars.size() && reader.good(); ++i) {
+        readCar(reader, floorSlots, loaded.cars[i]);
+    }
+    loaded.journeys.resize(reader.count(sizeof(std::int32_t) * 8));
+    for (std::size_t i = 0; i < loaded.journeys.size() && reader.good(); ++i) {
+        readJourney(reader, loaded.journeys[i]);
+    }
+    reader.ints(loaded.freeJourneySlots);
+    readPassengers(reader, loaded.passengers);
+    readMetrics(reader, loaded.metrics);
+
+    const std::size_t exitPassengers = reader.count(sizeof(std::int32_t) * 2 + sizeof(std::uint64_t));
+    std::vector<int> passengerIds(exitPassengers);
+    std::vector<std::vector<int>> exits(exitPassengers);
+    std::vector<int> used(exitPassengers);
+    for (std::size_t slot = 0; slot < exitPassengers && reader.good(); ++slot) {
+        passengerIds[slot] = reader.value<std::int32_t>();
+        used[slot] = reader.value<std::int32_t>();
+        reader.ints(exits[slot]);
+        bool validExits = used[slot] >= 0 && static_cast<std::size_t>(used[slot]) <= exits[slot].size();
+        for (int actionIndex : exits[slot]) {
+            validExits = validExits && actionIndex >= 0 && static_cast<std::size_t>(actionIndex) < knownActionCount;
+        }
+        if (!validExits) {
+            error = "invalid exit action";
+            return false;
+        }
+    }
+    loaded.exitActions.assign(passengerIds, exits, used);
+    loaded.exitActionPaired.resize(knownActionCount);
+    std::uint8_t flags = 0;
+    for (std::size_t i = 0; i < knownActionCount && reader.good(); ++i) {
+        if (i % 8 == 0) {
+            flags = reader.value<std::uint8_t>();
+        }
+        loaded.exitActionPaired[i] = (flags >> (i % 8)) & 1;
+    }
+
+    if (!reader.good()) {
+        error = "the checkpoint is truncated or corrupt";
+        return false;
+    }
+    if (!validCarsAndJourneys(config, loaded, error)) {
+        return false;
+    }
+    state = std::move(loaded);
+    return true;
+}
+
+bool CheckpointFile::save(const std::string &path, const SimulationConfig &config, const SimulationState &state,
+                          std::string &error)
+{
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out || !write(out, config, state) || !out.flush()) {
+            error = "cannot write " + temporaryPath;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+bool CheckpointFile::load(const std::string &path, const SimulationConfig &config, SimulationState &state,
+                          std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return read(in, config, state, error);
+}
@@ -0,0 +1,33 @@
+#ifndef CHECKPOINTFILE_H
+#define CHECKPOINTFILE_H
+
+#include "SimulationConfig.h"
+#include "SimulationState.h"
+#include <iosfwd>
+#include <string>
+
+/**
+ * @brief The CheckpointFile class writes a SimulationState to a binary file and reads it back, so a long run can
+ *        be resumed after a crash by an engine built from the same scenario.
+ *        The file starts with the seed, the building, the dispatch policy and the number of actions of the run
+ *        and is rejected for any other configuration. The sorted actions of the calendar and the random
+ *        substreams are not stored, they are rebuilt from the configuration and moved to the saved positions
+ */
+class CheckpointFile
+{
+public:
+    static bool write(std::ostream &out, const SimulationConfig &config, const SimulationState &state);
+
+    // Replaces state with the file's, returns false and sets error if the file is invalid or was saved
+    // with another configuration. Every count is bounded by the bytes left in the stream and every floor, car
+    // and journey index is checked, a corrupt file fails instead of crashing or stalling the engine
+    static bool read(std::istream &in, const SimulationConfig &config, SimulationState &state, std::string &error);
+
+    // Writes to a temporary file next to path then renames it, a crash while saving keeps the previous checkpoint
+    static bool save(const std::string &path, const SimulationConfig &config, const SimulationState &state,
+                     std::string &error);
+    static bool load(const std::string &path, const SimulationConfig &config, SimulationState &state,
+                     std::string &error);
+};
+
+#endif // CHECKPOINTFILE_H
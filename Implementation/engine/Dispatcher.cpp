@@ -0,0 +1,138 @@
+#include "Dispatcher.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+
+const char *const policyNames[] = {"nearest", "collective", "destination"};
+
+// Time steps a stop costs a car (doors open, boarding)
+const int stopCost = 1;
+
+// Picks the car with the lowest cost, ties go to the car with fewer passengers then the lower index
+template <typename CostFunction>
+int cheapestCar(const std::vector<ElevatorCar> &cars, CostFunction cost)
+{
+    int best = 0;
+    int bestCost = INT_MAX;
+    for (int i = 0; i < static_cast<int>(cars.size()); ++i) {
+        int carCost = cost(cars[i]);
+        if (carCost < bestCost ||
+            (carCost == bestCost && cars[i].passengersAssigned < cars[best].passengersAssigned)) {
+            best = i;
+            bestCost = carCost;
+        }
+    }
+    return best;
+}
+
+class NearestCarDispatcher : public Dispatcher
+{
+public:
+    int assign(const PassengerJourney &journey, const std::vector<ElevatorCar> &cars) const override {
+        return cheapestCar(cars, [&journey](const ElevatorCar &car) {
+            return std::abs(car.floorAt(journey.requestTimeStep) - journey.origin);
+        });
+    }
+
+    Policy policy() const override { return NearestCar; }
+};
+
+class CollectiveDispatcher : public Dispatcher
+{
+public:
+    int assign(const PassengerJourney &journey, const std::vector<ElevatorCar> &cars) const override {
+        return cheapestCar(cars, [&journey](const ElevatorCar &car) {
+            return sweepDistance(car, journey.requestTimeStep, journey.origin, journey.direction());
+        });
+    }
+
+    Policy policy() const override { return Collective; }
+};
+
+class DestinationDispatcher : public Dispatcher
+{
+public:
+    // Travel to the origin, plus a stop cost for every stop already planned and every new stop the journey adds
+    int assign(const PassengerJourney &journey, const std::vector<ElevatorCar> &cars) const override {
+        return cheapestCar(cars, [&journey](const ElevatorCar &car) {
+            int newStops = (car.stops.count(journey.origin) == 0) + (car.stops.count(journey.destination) == 0);
+            return sweepDistance(car, journey.requestTimeStep, journey.origin, journey.direction())
+                 + stopCost * static_cast<int>(car.stops.size())
+                 + 2 * stopCost * newStops;
+        });
+    }
+
+    Policy policy() const override { return DestinationDispatch; }
+};
+
+}
+
+std::unique_ptr<Dispatcher> Dispatcher::create(Policy policy)
+{
+    switch (policy) {
+    case NearestCar:
+        return std::unique_ptr<Dispatcher>(new NearestCarDispatcher());
+    case DestinationDispatch:
+        return std::unique_ptr<Dispatcher>(new DestinationDispatcher());
+    default:
+        return std::unique_ptr<Dispatcher>(new CollectiveDispatcher());
+    }
+}
+
+const char *Dispatcher::policyName(Policy policy)
+{
+    return policy < PolicyCount ? policyNames[policy] : "unknown";
+}
+
+bool Dispatcher::policyFromName(const std::string &name, Policy &policy)
+{
+    for (int i = 0; i < PolicyCount; ++i) {
+        if (name == policyNames[i]) {
+            policy = static_cast<Policy>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Estimates how far a car travels before it can pick up a call, assuming it finishes its sweep first
+ * @param car The car
+ * @param timeStep Time step of the call, a moving car is at the floor it is heading to at that time
+ * @param floor The calling floor
+ * @param callDirection 1 for an up call, -1 for a down call, 0 if the direction is unknown
+ * @return Number of floors travelled
+ */
+int Dispatcher::sweepDistance(const ElevatorCar &car, int timeStep, int floor, int callDirection)
+{
+    const int carFloor = car.floorAt(timeStep);
+    if (car.direction == ElevatorCar::None) {
+        return std::abs(carFloor - floor);
+    }
+
+    const int top = std::max(car.highestStop(), floor);
+    const int bottom = std::min(car.lowestStop(), floor);
+
+    if (car.direction == ElevatorCar::Up) {
+        // Ahead of the car and in its direction: picked up on the way
+        if (floor >= carFloor && callDirection >= 0) {
+            return floor - carFloor;
+        }
+        // Down call: picked up on the way back from the top of the sweep
+        if (callDirection <= 0) {
+            return (top - carFloor) + (top - floor);
+        }
+        // Up call behind the car: top of the sweep, bottom of the next one, then back up
+        return (top - carFloor) + (top - bottom) + (floor - bottom);
+    }
+
+    if (floor <= carFloor && callDirection <= 0) {
+        return carFloor - floor;
+    }
+    if (callDirection >= 0) {
+        return (carFloor - bottom) + (floor - bottom);
+    }
+    return (carFloor - bottom) + (top - bottom) + (top - floor);
+}
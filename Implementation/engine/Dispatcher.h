@@ -0,0 +1,49 @@
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include "ElevatorCar.h"
+#include "PassengerJourney.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The Dispatcher class is responsible for assigning each hall call to a car of the elevator bank.
+ *        Policies:
+ *        - NearestCar: the car closest to the calling floor, ignoring its direction
+ *        - Collective: SCAN/LOOK collective control, the car that reaches the floor first while
+ *          sweeping in its current direction
+ *        - DestinationDispatch: uses the destination entered at the hall call to group passengers
+ *          into cars that already stop at their origin or destination
+ */
+class Dispatcher
+{
+public:
+    enum Policy {
+        NearestCar,
+        Collective,
+        DestinationDispatch,
+        PolicyCount
+    };
+
+    virtual ~Dispatcher() = default;
+
+    // Returns the index of the car that serves the journey, moving cars are where they are at its request time step
+    virtual int assign(const PassengerJourney &journey, const std::vector<ElevatorCar> &cars) const = 0;
+
+    virtual Policy policy() const = 0;
+
+    static std::unique_ptr<Dispatcher> create(Policy policy);
+
+    // Name used by the log and the command line, e.g. "collective"
+    static const char *policyName(Policy policy);
+
+    // Parses a name returned by policyName, returns false if the name is unknown
+    static bool policyFromName(const std::string &name, Policy &policy);
+
+    // Floors a car travels from timeStep on before reaching floor heading in callDirection when it keeps
+    // sweeping (LOOK)
+    static int sweepDistance(const ElevatorCar &car, int timeStep, int floor, int callDirection);
+};
+
+#endif // DISPATCHER_H
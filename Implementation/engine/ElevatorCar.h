@@ -0,0 +1,58 @@
+#ifndef ELEVATORCAR_H
+#define ELEVATORCAR_H
+
+#include "MovementSegment.h"
+#include <set>
+#include <vector>
+
+/**
+ * @brief The ElevatorCar struct holds the state of one car of the elevator bank:
+ *        - Its floor, direction and state, and the time step it finishes its current trip or stop
+ *        - While moving, the trip to the next stop: the car is only handled again when it arrives, its position in
+ *          between is computed from the trip
+ *        - The floors it still has to stop at (hall calls assigned to it and its passengers' destinations)
+ *        - The passengers waiting for it and riding it, indexed by floor
+ */
+struct ElevatorCar {
+    // For displaying elevator states
+    enum State {
+        Idle,
+        Moving,
+        Stopped
+    };
+
+    enum Direction {
+        Down = -1,
+        None = 0,
+        Up = 1
+    };
+
+    int id = 1;                // 1-based number shown in the log
+    int floor = 1;             // While Moving, the stop the car is heading to
+    State state = Idle;
+    Direction direction = None;
+    std::set<int> stops;                            // Floors the car still has to stop at
+    std::vector<std::vector<int>> waitingByFloor;   // Journeys assigned to this car, by origin floor
+    std::vector<std::vector<int>> ridingByFloor;    // Journeys riding this car, by destination floor
+    int passengersAssigned = 0;                     // Waiting plus riding journeys
+    int readyTimeStep = 0;                          // The car reaches floor / closes its doors at this time step
+    MovementSegment trip;                           // While Moving, the trip to floor, ending at readyTimeStep
+
+    ElevatorCar() = default;
+    ElevatorCar(int carId, int floorCount)
+        : id(carId), waitingByFloor(floorCount + 1), ridingByFloor(floorCount + 1) {}
+
+    bool hasStopAbove() const { return !stops.empty() && *stops.rbegin() > floor; }
+    bool hasStopBelow() const { return !stops.empty() && *stops.begin() < floor; }
+    int highestStop() const { return stops.empty() ? floor : *stops.rbegin(); }
+    int lowestStop() const { return stops.empty() ? floor : *stops.begin(); }
+
+    // Floor the car is at, or while Moving the floor it is heading to at timeStep
+    int floorAt(int timeStep) const { return state == Moving ? trip.floorAt(timeStep) : floor; }
+
+    static const char *stateName(State state) {
+        return state == Idle ? "Idle" : state == Moving ? "Moving" : "Stopped";
+    }
+};
+
+#endif // ELEVATORCAR_H
@@ -0,0 +1,150 @@
+#include "EventCalendar.h"
+#include <algorithm>
+
+EventCalendar::EventCalendar()
+    : sorted(std::make_shared<const std::vector<Entry>>()),
+      cursor(0),
+      nextSequence(0)
+{
+}
+
+bool EventCalendar::later(const Entry &a, const Entry &b)
+{
+    if (a.timeStep != b.timeStep) {
+        return a.timeStep > b.timeStep;
+    }
+    return a.sequence > b.sequence;
+}
+
+/**
+ * @brief Sorts the actions once by time step, stable so actions of one time step keep their list order
+ * @param actions The scenario's passenger actions
+ */
+void EventCalendar::build(const ActionTable &actions)
+{
+    build(actions, actions.size());
+}
+
+void EventCalendar::build(const ActionTable &actions, std::size_t count)
+{
+    // Only the time step column is read
+    build(actions.getTimeSteps(), count);
+}
+
+void EventCalendar::build(const std::vector<std::int32_t> &timeSteps, std::size_t count)
+{
+    count = std::min(count, timeSteps.size());
+
+    std::vector<Entry> entries;
+    entries.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        entries.push_back(Entry{timeSteps[i], static_cast<int>(i), static_cast<int>(i)});
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.timeStep < b.timeStep;
+    });
+
+    clear();
+    sorted = std::make_shared<const std::vector<Entry>>(std::move(entries));
+    nextSequence = static_cast<int>(count);
+}
+
+/**
+ * @brief Moves a freshly built calendar to a position saved from a calendar built from the same actions
+ * @param cursor Entries handed out from the built actions
+ * @param scheduled The heap of actions scheduled mid-run, as returned by getScheduled()
+ * @param nextSequence Sequence of the next scheduled action
+ */
+void EventCalendar::restore(std::size_t cursor, const std::vector<Entry> &scheduled, int nextSequence)
+{
+    this->cursor = std::min(cursor, sorted->size());
+    heap = scheduled;
+    this->nextSequence = nextSequence;
+}
+
+void EventCalendar::schedule(int timeStep, int actionIndex)
+{
+    heap.push_back(Entry{timeStep, nextSequence++, actionIndex});
+    std::push_heap(heap.begin(), heap.end(), later);
+}
+
+/**
+ * @brief Moves the built actions whose time step changed to their new place, the other ones keep their order
+ *        and are shared with the copies of the calendar as long as no time step changed
+ * @param actions The edited table, the built actions keep their index
+ */
+void EventCalendar::refresh(const ActionTable &actions)
+{
+    const std::vector<std::int32_t> &timeSteps = actions.getTimeSteps();
+    auto moved = [&timeSteps](const Entry &entry) {
+        return entry.timeStep != timeSteps[entry.actionIndex];
+    };
+
+    if (std::any_of(sorted->begin(), sorted->end(), moved)) {
+        std::vector<Entry> kept;
+        std::vector<Entry> edited;
+        kept.reserve(sorted->size());
+        for (const Entry &entry : *sorted) {
+            if (moved(entry)) {
+                edited.push_back(Entry{timeSteps[entry.actionIndex], entry.sequence, entry.actionIndex});
+            } else {
+                kept.push_back(entry);
+            }
+        }
+
+        // Built actions are ordered by (time step, list order) and their sequence is their list index
+        auto earlier = [](const Entry &a, const Entry &b) {
+            return a.timeStep != b.timeStep ? a.timeStep < b.timeStep : a.sequence < b.sequence;
+        };
+        std::sort(edited.begin(), edited.end(), earlier);
+        std::vector<Entry> entries(kept.size() + edited.size());
+        std::merge(kept.begin(), kept.end(), edited.begin(), edited.end(), entries.begin(), earlier);
+        sorted = std::make_shared<const std::vector<Entry>>(std::move(entries));
+    }
+
+    for (Entry &entry : heap) {
+        entry.timeStep = timeSteps[entry.actionIndex];
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+}
+
+int EventCalendar::nextTimeStep() const
+{
+    const std::vector<Entry> &entries = *sorted;
+    if (cursor < entries.size() && (heap.empty() || entries[cursor].timeStep <= heap.front().timeStep)) {
+        return entries[cursor].timeStep;
+    }
+    return heap.empty() ? -1 : heap.front().timeStep;
+}
+
+/**
+ * @brief Hands out the actions due at timeStep, actions left over from earlier time steps are dropped
+ * @param timeStep The time step being processed
+ * @param due Receives the indices of the due actions in scheduling order
+ */
+void EventCalendar::takeDue(int timeStep, std::vector<int> &due)
+{
+    // Actions from build() were scheduled before any action from schedule(), so they come first
+    const std::vector<Entry> &entries = *sorted;
+    for (; cursor < entries.size() && entries[cursor].timeStep <= timeStep; ++cursor) {
+        if (entries[cursor].timeStep == timeStep) {
+            due.push_back(entries[cursor].actionIndex);
+        }
+    }
+
+    while (!heap.empty() && heap.front().timeStep <= timeStep) {
+        if (heap.front().timeStep == timeStep) {
+            due.push_back(heap.front().actionIndex);
+        }
+        std::pop_heap(heap.begin(), heap.end(), later);
+        heap.pop_back();
+    }
+}
+
+void EventCalendar::clear()
+{
+    sorted = std::make_shared<const std::vector<Entry>>();
+    cursor = 0;
+    heap.clear();
+    nextSequence = 0;
+}
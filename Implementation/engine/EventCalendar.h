@@ -0,0 +1,72 @@
+#ifndef EVENTCALENDAR_H
+#define EVENTCALENDAR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ActionTable.h"
+
+/**
+ * @brief The EventCalendar class is responsible for:
+ *        - Keeping the scheduled passenger actions, or the safety events, ordered by time step
+ *        - Handing out only the actions due at a time step, in the order they were scheduled
+ *        The actions known at start are sorted once and read through a cursor, actions added
+ *        mid-run go to a small min-heap, so a tick only touches the actions that are due.
+ *        The sorted actions are shared between copies, copying a calendar for a checkpoint only copies
+ *        its cursor and the actions scheduled mid-run
+ */
+class EventCalendar
+{
+public:
+    struct Entry {
+        int timeStep;
+        int sequence;     // Scheduling order, keeps actions of the same time step in insertion order
+        int actionIndex;
+    };
+
+    EventCalendar();
+
+    // Replaces the calendar's content with every action of the table, O(n log n)
+    void build(const ActionTable &actions);
+    // Same with only the first count actions of the table
+    void build(const ActionTable &actions, std::size_t count);
+    // Same with any time-stamped list, the handed out indices are positions in timeSteps
+    void build(const std::vector<std::int32_t> &timeSteps, std::size_t count);
+
+    // Adds one action, allowed while the simulation is running, O(log n)
+    void schedule(int timeStep, int actionIndex);
+
+    // Removes every action due at or before timeStep, appending those due exactly at timeStep to due
+    void takeDue(int timeStep, std::vector<int> &due);
+
+    void clear();
+    bool isEmpty() const { return size() == 0; }
+    std::size_t size() const { return (sorted->size() - cursor) + heap.size(); }
+
+    // Time step of the earliest scheduled action, -1 if the calendar is empty
+    int nextTimeStep() const;
+
+    // The calendar's position, a calendar built from the same actions and given the same position by restore()
+    // hands out the same actions from then on
+    std::size_t getBuiltCount() const { return sorted->size(); }
+    std::size_t getCursor() const { return cursor; }
+    const std::vector<Entry> &getScheduled() const { return heap; }
+    int getNextSequence() const { return nextSequence; }
+    void restore(std::size_t cursor, const std::vector<Entry> &scheduled, int nextSequence);
+
+    // Reads the time steps of the actions from the table again after some were edited, O(n) plus sorting the
+    // edited actions. Edited actions must not have been handed out, before or after the edit
+    void refresh(const ActionTable &actions);
+
+private:
+    // Heap comparator, puts the earliest (time step, sequence) at the front
+    static bool later(const Entry &a, const Entry &b);
+
+    std::shared_ptr<const std::vector<Entry>> sorted; // Actions from build(), in (time step, scheduling order)
+    std::size_t cursor;         // First entry of sorted that was not handed out yet
+    std::vector<Entry> heap;    // Actions from schedule()
+    int nextSequence;
+};
+
+#endif // EVENTCALENDAR_H
@@ -0,0 +1,220 @@
+#include "ExitActionIndex.h"
+#include <algorithm>
+
+ExitActionIndex::ExitActionIndex()
+{
+    std::shared_ptr<Lists> empty = std::make_shared<Lists>();
+    empty->offsets.push_back(0);
+    lists = empty;
+}
+
+/**
+ * @brief Inserts each new exit at the upper bound of its time step among the passenger's exits not used up,
+ *        so exits of one time step keep their list order
+ */
+void ExitActionIndex::add(const ActionTable &actions, std::size_t firstIndex)
+{
+    const std::vector<std::int32_t> &ids = actions.getPassengerIds();
+    const std::vector<std::uint8_t> &types = actions.getTypes();
+
+    std::vector<std::pair<int, int>> added;   // (passenger id, action index)
+    for (std::size_t i = firstIndex; i < actions.size(); ++i) {
+        if (types[i] == PassengerAction::ExitCar) {
+            added.emplace_back(ids[i], static_cast<int>(i));
+        }
+    }
+    if (added.empty()) {
+        return;
+    }
+    std::sort(added.begin(), added.end());
+
+    std::vector<Change> changes;
+    for (const std::pair<int, int> &exit : added) {
+        if (changes.empty() || changes.back().passengerId != exit.first) {
+            const int slot = slotOf(exit.first);
+            changes.push_back(Change{exit.first, slot >= 0 ? exitsAt(slot) : std::vector<int>(),
+                                     slot >= 0 ? used[slot] : 0});
+        }
+
+        Change &change = changes.back();
+        auto position = std::upper_bound(change.exits.begin() + change.used, change.exits.end(),
+                                         actions.timeStepAt(exit.second), [&actions](int timeStep, int index) {
+            return timeStep < actions.timeStepAt(index);
+        });
+        change.exits.insert(position, exit.second);
+    }
+    apply(changes);
+}
+
+/**
+ * @brief Drops the passengers' exits and files them again from the table, in time step then list order
+ */
+void ExitActionIndex::reindex(const ActionTable &actions, std::size_t count, const std::vector<int> &passengerIds)
+{
+    if (passengerIds.empty()) {
+        return;
+    }
+
+    std::vector<Change> changes;
+    for (int passengerId : passengerIds) {
+        changes.push_back(Change{passengerId, std::vector<int>(), 0});
+    }
+    std::sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.passengerId < b.passengerId;
+    });
+    changes.erase(std::unique(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.passengerId == b.passengerId;
+    }), changes.end());
+
+    const std::vector<std::int32_t> &ids = actions.getPassengerIds();
+    count = std::min(count, actions.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        if (actions.typeAt(i) != PassengerAction::ExitCar) {
+            continue;
+        }
+        auto change = std::lower_bound(changes.begin(), changes.end(), ids[i], [](const Change &a, int passengerId) {
+            return a.passengerId < passengerId;
+        });
+        if (change != changes.end() && change->passengerId == ids[i]) {
+            change->exits.push_back(static_cast<int>(i));
+        }
+    }
+    for (Change &change : changes) {
+        std::stable_sort(change.exits.begin(), change.exits.end(), [&actions](int a, int b) {
+            return actions.timeStepAt(a) < actions.timeStepAt(b);
+        });
+    }
+    apply(changes);
+}
+
+int ExitActionIndex::take(const ActionTable &actions, int passengerId, int timeStep)
+{
+    const int slot = slotOf(passengerId);
+    if (slot < 0) {
+        return -1;
+    }
+
+    const int first = lists->offsets[slot];
+    const int end = lists->offsets[slot + 1];
+    int position = first + used[slot];
+    while (position < end && actions.timeStepAt(lists->exits[position]) < timeStep) {
+        ++position;
+    }
+    if (position == end) {
+        used[slot] = end - first;
+        return -1;
+    }
+    used[slot] = position + 1 - first;
+    return lists->exits[position];
+}
+
+void ExitActionIndex::clear()
+{
+    *this = ExitActionIndex();
+}
+
+/**
+ * @brief Walks both passenger lists in id order, a passenger missing on one side has no exits left there
+ */
+bool ExitActionIndex::sameRemaining(const ExitActionIndex &other) const
+{
+    const std::vector<int> &ids = lists->passengerIds;
+    const std::vector<int> &otherIds = other.lists->passengerIds;
+    std::size_t slot = 0;
+    std::size_t otherSlot = 0;
+    while (slot < ids.size() || otherSlot < otherIds.size()) {
+        std::size_t count = 0;
+        std::size_t otherCount = 0;
+        const int *exits = nullptr;
+        const int *otherExits = nullptr;
+        if (otherSlot == otherIds.size() || (slot < ids.size() && ids[slot] < otherIds[otherSlot])) {
+            exits = remaining(slot++, count);
+        } else if (slot == ids.size() || otherIds[otherSlot] < ids[slot]) {
+            otherExits = other.remaining(otherSlot++, otherCount);
+        } else {
+            exits = remaining(slot++, count);
+            otherExits = other.remaining(otherSlot++, otherCount);
+        }
+        if (count != otherCount || !std::equal(exits, exits + count, otherExits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<int> ExitActionIndex::exitsAt(std::size_t slot) const
+{
+    return std::vector<int>(lists->exits.begin() + lists->offsets[slot], lists->exits.begin() + lists->offsets[slot + 1]);
+}
+
+void ExitActionIndex::assign(const std::vector<int> &passengerIds, const std::vector<std::vector<int>> &exits,
+                             const std::vector<int> &used)
+{
+    std::vector<Change> changes;
+    for (std::size_t i = 0; i < passengerIds.size(); ++i) {
+        changes.push_back(Change{passengerIds[i], exits[i], used[i]});
+    }
+    std::sort(changes.begin(), changes.end(), [](const Change &a, const Change &b) {
+        return a.passengerId < b.passengerId;
+    });
+    clear();
+    apply(changes);
+}
+
+int ExitActionIndex::slotOf(int passengerId) const
+{
+    const std::vector<int> &ids = lists->passengerIds;
+    auto found = std::lower_bound(ids.begin(), ids.end(), passengerId);
+    return found != ids.end() && *found == passengerId ? static_cast<int>(found - ids.begin()) : -1;
+}
+
+/**
+ * @brief Merges the unchanged passengers and the changed ones into new flat lists, in passenger id order
+ */
+void ExitActionIndex::apply(const std::vector<Change> &changes)
+{
+    const Lists &current = *lists;
+    std::shared_ptr<Lists> merged = std::make_shared<Lists>();
+    std::vector<int> mergedUsed;
+    merged->passengerIds.reserve(current.passengerIds.size() + changes.size());
+    merged->offsets.reserve(current.passengerIds.size() + changes.size() + 1);
+    merged->offsets.push_back(0);
+    mergedUsed.reserve(current.passengerIds.size() + changes.size());
+
+    std::size_t slot = 0;
+    auto change = changes.begin();
+    while (slot < current.passengerIds.size() || change != changes.end()) {
+        if (change == changes.end() || (slot < current.passengerIds.size() &&
+                                        current.passengerIds[slot] < change->passengerId)) {
+            merged->passengerIds.push_back(current.passengerIds[slot]);
+            merged->exits.insert(merged->exits.end(), current.exits.begin() + current.offsets[slot],
+                                 current.exits.begin() + current.offsets[slot + 1]);
+            mergedUsed.push_back(used[slot]);
+            ++slot;
+        } else {
+            if (slot < current.passengerIds.size() && current.passengerIds[slot] == change->passengerId) {
+                ++slot;
+            }
+            if (!change->exits.empty()) {
+                merged->passengerIds.push_back(change->passengerId);
+                merged->exits.insert(merged->exits.end(), change->exits.begin(), change->exits.end());
+                mergedUsed.push_back(change->used);
+            }
+            ++change;
+        }
+        if (merged->offsets.size() == merged->passengerIds.size()) {
+            merged->offsets.push_back(static_cast<int>(merged->exits.size()));
+        }
+    }
+
+    lists = merged;
+    used.swap(mergedUsed);
+}
+
+// Exits of the slot not used up yet
+const int *ExitActionIndex::remaining(std::size_t slot, std::size_t &count) const
+{
+    const int first = lists->offsets[slot] + used[slot];
+    count = static_cast<std::size_t>(lists->offsets[slot + 1] - first);
+    return lists->exits.data() + first;
+}
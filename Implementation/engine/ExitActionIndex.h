@@ -0,0 +1,69 @@
+#ifndef EXITACTIONINDEX_H
+#define EXITACTIONINDEX_H
+
+#include "ActionTable.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief The ExitActionIndex class pairs car requests with the ExitCar actions giving their destination:
+ *        - The ExitCar actions are filed by passenger, in time step order
+ *        - A car request takes its passenger's first exit due at or after it, exits due before it are skipped
+ *        The lists are flat arrays, immutable and shared between copies, only the number of exits each passenger
+ *        used up is copied, so a copy for a checkpoint costs one int per passenger. Filing exits copies the lists
+ */
+class ExitActionIndex
+{
+public:
+    ExitActionIndex();
+
+    // Files the ExitCar actions of actions[firstIndex, end) behind the exits already filed for their passenger,
+    // among the ones not used up yet by time step
+    void add(const ActionTable &actions, std::size_t firstIndex);
+
+    // Files every ExitCar among the first count actions of the passengers again, none of them used up
+    void reindex(const ActionTable &actions, std::size_t count, const std::vector<int> &passengerIds);
+
+    // Uses up the passenger's exits due before timeStep and the first one due at or after it,
+    // returns the index of that exit or -1 if there is none
+    int take(const ActionTable &actions, int passengerId, int timeStep);
+
+    void clear();
+
+    // True if every passenger has the same exits left
+    bool sameRemaining(const ExitActionIndex &other) const;
+
+    // Passengers in id order with their exits and how many of them are used up, for the checkpoint file
+    std::size_t passengerCount() const { return lists->passengerIds.size(); }
+    int passengerAt(std::size_t slot) const { return lists->passengerIds[slot]; }
+    std::vector<int> exitsAt(std::size_t slot) const;
+    int usedAt(std::size_t slot) const { return used[slot]; }
+    // Replaces the index, one entry per passenger, used[i] of exits[i] are used up
+    void assign(const std::vector<int> &passengerIds, const std::vector<std::vector<int>> &exits,
+                const std::vector<int> &used);
+
+private:
+    struct Lists {
+        std::vector<int> passengerIds;   // Ascending, the position of a passenger is its slot
+        std::vector<int> offsets;        // Exits of slot s are exits[offsets[s], offsets[s + 1])
+        std::vector<int> exits;          // Action indices
+    };
+
+    // A passenger whose exits are replaced
+    struct Change {
+        int passengerId;
+        std::vector<int> exits;
+        int used;
+    };
+
+    int slotOf(int passengerId) const;
+    // Copies the lists with the changes applied, changes are sorted by passenger id
+    void apply(const std::vector<Change> &changes);
+    const int *remaining(std::size_t slot, std::size_t &count) const;
+
+    std::shared_ptr<const Lists> lists;
+    std::vector<int> used;               // Exits used up, by slot
+};
+
+#endif // EXITACTIONINDEX_H
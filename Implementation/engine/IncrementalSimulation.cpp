@@ -0,0 +1,218 @@
+#include "IncrementalSimulation.h"
+#include "SimulationEngine.h"
+#include <algorithm>
+#include <climits>
+#include <unordered_set>
+
+namespace {
+
+bool sameAction(const ActionTable &a, const ActionTable &b, std::size_t index)
+{
+    return a.timeStepAt(index) == b.timeStepAt(index) && a.typeAt(index) == b.typeAt(index)
+        && a.getFloors()[index] == b.getFloors()[index] && a.getPassengerIds()[index] == b.getPassengerIds()[index];
+}
+
+// Metrics of a later point of a run, moved onto another run that matched it from the point from on.
+// The runs requested the same journeys and started the same evacuation, only the sums and latency histograms differ
+SimulationMetrics rebased(const SimulationMetrics &later, const SimulationMetrics &from, const SimulationMetrics &to)
+{
+    SimulationMetrics metrics = later;
+    metrics.journeysCompleted += to.journeysCompleted - from.journeysCompleted;
+    metrics.totalWaitSteps += to.totalWaitSteps - from.totalWaitSteps;
+    metrics.totalRideSteps += to.totalRideSteps - from.totalRideSteps;
+    metrics.latency.add(to.latency);
+    metrics.latency.subtract(from.latency);
+    return metrics;
+}
+
+}
+
+IncrementalSimulation::IncrementalSimulation(const SimulationConfig &config, int checkpointInterval, int maxSteps)
+    : config(config),
+      checkpointInterval(std::max(1, checkpointInterval)),
+      maxSteps(maxSteps)
+{
+}
+
+/**
+ * @brief Runs the whole scenario and keeps its checkpoints
+ * @return The outcome of the run
+ */
+const IncrementalSimulation::Outcome &IncrementalSimulation::run()
+{
+    SimulationEngine engine(config);
+    engine.setCheckpointInterval(checkpointInterval);
+    engine.start();
+    engine.run(maxSteps);
+
+    checkpoints.clear();
+    finishRun(engine, 0);
+    return outcome;
+}
+
+/**
+ * @brief Re-simulates the part of the run the edit can change
+ * @param actions The edited action list
+ * @return The outcome of the edited scenario
+ */
+const IncrementalSimulation::Outcome &IncrementalSimulation::editActions(const PassengerActionSnapshot &actions)
+{
+    if (!actions || actions == config.actions) {
+        return outcome;
+    }
+
+    const PassengerActionSnapshot previousActions = config.actions;
+    const int previousFirstRandomPassengerId = SimulationEngine::firstRandomPassengerIdOf(config);
+    config.actions = actions;
+    // A new passenger ID past the random passengers' renumbers them, and every row of the previous run with them
+    if (actions->size() < previousActions->size() || checkpoints.empty()
+        || SimulationEngine::firstRandomPassengerIdOf(config) != previousFirstRandomPassengerId) {
+        return run();
+    }
+
+    const EditRange edits = findEdits(*previousActions, *actions);
+    if (edits.firstTimeStep >= outcome.steps) {
+        // The previous run ended before reading any edited action
+        for (auto &checkpoint : checkpoints) {
+            checkpoint.second.reindexExits(*actions, edits.exitPassengers);
+        }
+        lastStats = RunStats();
+        lastStats.resumedFrom = outcome.steps;
+        lastStats.convergedAt = outcome.steps;
+        return outcome;
+    }
+
+    // Keep the checkpoints the edit cannot change, they continue with the edited actions from now on
+    std::map<int, SimulationState> previousRun;
+    previousRun.swap(checkpoints);
+    while (!previousRun.empty() && previousRun.begin()->first <= edits.firstTimeStep) {
+        checkpoints.insert(previousRun.extract(previousRun.begin()));
+    }
+    if (checkpoints.empty()) {
+        return run();
+    }
+    for (auto &checkpoint : checkpoints) {
+        checkpoint.second.reindexExits(*actions, edits.exitPassengers);
+    }
+    const Outcome previousOutcome = outcome;
+
+    const auto restorePoint = std::prev(checkpoints.end());
+    const int resumedFrom = restorePoint->first;
+    SimulationEngine engine(config);
+    engine.setCheckpointInterval(checkpointInterval);
+    if (!engine.restoreEditedState(restorePoint->second, edits.exitPassengers)) {
+        return run();
+    }
+
+    // Compare with the previous run at its checkpoints past the last edited action
+    const int limit = maxSteps < 0 ? INT_MAX : maxSteps;
+    auto previousCheckpoint = previousRun.upper_bound(std::max(edits.lastTimeStep, resumedFrom));
+    while (engine.isRunning() && engine.getCurrentTimeStep() < limit) {
+        const int target = previousCheckpoint != previousRun.end() ? std::min(previousCheckpoint->first, limit) : limit;
+        engine.run(target == INT_MAX ? -1 : target - engine.getCurrentTimeStep());
+
+        if (previousCheckpoint == previousRun.end() || engine.getCurrentTimeStep() != previousCheckpoint->first) {
+            continue;
+        }
+        const SimulationState &previousState = previousCheckpoint->second;
+        if (!engine.isRunning() || !engine.getState().evolvesLike(previousState)) {
+            ++previousCheckpoint;
+            continue;
+        }
+
+        // Same state, so the rest of the run is the previous one's. Only the metrics summed so far and the
+        // passengers' rows written before differ
+        const int convergedAt = previousCheckpoint->first;
+        const SimulationMetrics from = previousState.metrics;
+        const SimulationMetrics &to = engine.getMetrics();
+
+        checkpoints.insert(engine.getCheckpoints().begin(), engine.getCheckpoints().end());
+        checkpoints[convergedAt] = engine.getState();
+        // Each table is rebased on the one of the checkpoint before, a row written between the two differs from
+        // its version there, and the blocks the two still share are skipped whole
+        PassengerTable laterFrom = previousState.passengers;
+        const PassengerTable *laterTo = &engine.getPassengers();
+        for (auto later = std::next(previousCheckpoint); later != previousRun.end(); ++later) {
+            later->second.metrics = rebased(later->second.metrics, from, to);
+            PassengerTable laterPassengers = later->second.passengers;
+            later->second.passengers = PassengerTable::rebased(laterPassengers, laterFrom, *laterTo);
+            laterFrom = std::move(laterPassengers);
+            laterTo = &later->second.passengers;
+        }
+        outcome = previousOutcome;
+        outcome.metrics = rebased(previousOutcome.metrics, from, to);
+        outcome.passengers = PassengerTable::rebased(previousOutcome.passengers, laterFrom, *laterTo);
+
+        previousRun.erase(previousRun.begin(), std::next(previousCheckpoint));
+        checkpoints.merge(previousRun);
+        lastStats.resumedFrom = resumedFrom;
+        lastStats.convergedAt = convergedAt;
+        lastStats.simulatedSteps = convergedAt - resumedFrom;
+        return outcome;
+    }
+
+    finishRun(engine, resumedFrom);
+    return outcome;
+}
+
+/**
+ * @brief Takes the outcome and the checkpoints of a run that was simulated to its end from resumedFrom
+ */
+void IncrementalSimulation::finishRun(SimulationEngine &engine, int resumedFrom)
+{
+    outcome.steps = engine.getCurrentTimeStep();
+    outcome.running = engine.isRunning();
+    outcome.completedPassengers = engine.getCompletedPassengers();
+    outcome.metrics = engine.getMetrics();
+    outcome.passengers = engine.getPassengers();
+
+    checkpoints.erase(checkpoints.lower_bound(resumedFrom), checkpoints.end());
+    checkpoints.insert(engine.getCheckpoints().begin(), engine.getCheckpoints().end());
+    checkpointInterval = std::max(checkpointInterval, engine.getCheckpointInterval());
+
+    lastStats.resumedFrom = resumedFrom;
+    lastStats.convergedAt = -1;
+    lastStats.simulatedSteps = outcome.steps - resumedFrom;
+}
+
+/**
+ * @brief Compares the lists action by action. An edited action is read at its time step, an edited ExitCar
+ *        already when a car request of its passenger is paired with it, so the range starts at the earliest
+ *        car request of that passenger in either list
+ */
+IncrementalSimulation::EditRange IncrementalSimulation::findEdits(const ActionTable &previous,
+                                                                  const ActionTable &edited) const
+{
+    EditRange range{INT_MAX, -1, {}};
+    std::unordered_set<int> exitPassengers;
+    auto addEdit = [&range, &exitPassengers](const ActionTable &actions, std::size_t index) {
+        range.firstTimeStep = std::min(range.firstTimeStep, actions.timeStepAt(index));
+        range.lastTimeStep = std::max(range.lastTimeStep, actions.timeStepAt(index));
+        if (actions.typeAt(index) == PassengerAction::ExitCar) {
+            exitPassengers.insert(actions.getPassengerIds()[index]);
+        }
+    };
+
+    for (std::size_t i = 0; i < previous.size(); ++i) {
+        if (!sameAction(previous, edited, i)) {
+            addEdit(previous, i);
+            addEdit(edited, i);
+        }
+    }
+    for (std::size_t i = previous.size(); i < edited.size(); ++i) {
+        addEdit(edited, i);
+    }
+
+    if (!exitPassengers.empty()) {
+        for (const ActionTable *actions : {&previous, &edited}) {
+            const std::vector<std::int32_t> &ids = actions->getPassengerIds();
+            for (std::size_t i = 0; i < actions->size(); ++i) {
+                if (actions->typeAt(i) == PassengerAction::RequestCar && exitPassengers.count(ids[i])) {
+                    range.firstTimeStep = std::min(range.firstTimeStep, actions->timeStepAt(i));
+                }
+            }
+        }
+    }
+    range.exitPassengers.assign(exitPassengers.begin(), exitPassengers.end());
+    return range;
+}
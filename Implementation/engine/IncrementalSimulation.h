@@ -0,0 +1,73 @@
+#ifndef INCREMENTALSIMULATION_H
+#define INCREMENTALSIMULATION_H
+
+#include "SimulationConfig.h"
+#include "SimulationMetrics.h"
+#include "SimulationState.h"
+#include <map>
+#include <vector>
+
+class SimulationEngine;
+
+/**
+ * @brief The IncrementalSimulation class is responsible for re-running a scenario after its actions were edited
+ *        ("what-if" planning) without simulating it again from time step 0:
+ *        - The first run keeps a checkpoint of the state every few time steps
+ *        - An edit restarts from the last checkpoint before the earliest time step the edit can change
+ *        - At every later checkpoint past the last edited action the new state is compared with the previous
+ *          run's, once they match the rest of the run is the same and the previous run's outcome is reused
+ *        Runs are silent, the outcome is the metrics and the passenger table of the whole run. Both are moved onto
+ *        the edited run for the checkpoints and the outcome reused from the previous run
+ */
+class IncrementalSimulation
+{
+public:
+    struct Outcome {
+        int steps = 0;                  // Time steps processed
+        bool running = false;           // True if the run hit the time step limit
+        int completedPassengers = 0;
+        SimulationMetrics metrics;
+        PassengerTable passengers;
+    };
+
+    // How the last run() or editActions() got its outcome
+    struct RunStats {
+        int resumedFrom = 0;            // Time step the simulation restarted from
+        int convergedAt = -1;           // Time step from which the previous run was reused, -1 if none
+        int simulatedSteps = 0;
+    };
+
+    IncrementalSimulation(const SimulationConfig &config, int checkpointInterval, int maxSteps = -1);
+
+    // Runs the scenario from time step 0
+    const Outcome &run();
+
+    // Replaces the action list with an edited version of it and updates the outcome. Actions may be changed in
+    // place or appended, a shorter list is run from time step 0
+    const Outcome &editActions(const PassengerActionSnapshot &actions);
+
+    const Outcome &getOutcome() const { return outcome; }
+    const RunStats &getLastStats() const { return lastStats; }
+    const SimulationConfig &getConfig() const { return config; }
+    const std::map<int, SimulationState> &getCheckpoints() const { return checkpoints; }
+
+private:
+    // Time steps an edit can change: from the first one its actions are read, to the last one they are due
+    struct EditRange {
+        int firstTimeStep;
+        int lastTimeStep;
+        std::vector<int> exitPassengers;  // Passengers with an edited ExitCar
+    };
+
+    EditRange findEdits(const ActionTable &previous, const ActionTable &edited) const;
+    void finishRun(SimulationEngine &engine, int resumedFrom);
+
+    SimulationConfig config;
+    int checkpointInterval;
+    int maxSteps;
+    std::map<int, SimulationState> checkpoints;
+    Outcome outcome;
+    RunStats lastStats;
+};
+
+#endif // INCREMENTALSIMULATION_H
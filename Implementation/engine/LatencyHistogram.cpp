@@ -0,0 +1,120 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// Index of the highest set bit, value > 0
+int highestBit(std::uint32_t value)
+{
+    int bit = 0;
+    for (int shift = 16; shift > 0; shift /= 2) {
+        if (value >> shift) {
+            value >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+}
+
+}
+
+LatencyHistogram::LatencyHistogram()
+    : total(0),
+      sum(0),
+      maximum(0)
+{
+}
+
+/**
+ * @brief Values in [2^e, 2^(e + 1)) with e >= subBucketBits share 2^(e - subBucketBits) per bucket
+ */
+std::size_t LatencyHistogram::bucketOf(int value)
+{
+    if (value < subBucketCount) {
+        return static_cast<std::size_t>(std::max(value, 0));
+    }
+    const int exponent = highestBit(static_cast<std::uint32_t>(value));
+    const int shift = exponent - subBucketBits;
+    return static_cast<std::size_t>(subBucketCount + shift * subBucketCount + ((value >> shift) - subBucketCount));
+}
+
+int LatencyHistogram::highestValueOf(std::size_t bucket)
+{
+    if (bucket < static_cast<std::size_t>(subBucketCount)) {
+        return static_cast<int>(bucket);
+    }
+    const int shift = static_cast<int>(bucket / subBucketCount) - 1;
+    const long long first = static_cast<long long>(subBucketCount + bucket % subBucketCount) << shift;
+    return static_cast<int>(std::min<long long>(first + (1LL << shift) - 1, INT_MAX));
+}
+
+void LatencyHistogram::record(int value)
+{
+    value = std::max(value, 0);
+    const std::size_t bucket = bucketOf(value);
+    if (bucket >= buckets.size()) {
+        buckets.resize(bucket + 1, 0);
+    }
+    ++buckets[bucket];
+    ++total;
+    sum += static_cast<std::uint64_t>(value);
+    maximum = std::max(maximum, value);
+}
+
+void LatencyHistogram::add(const LatencyHistogram &other)
+{
+    if (other.buckets.size() > buckets.size()) {
+        buckets.resize(other.buckets.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    maximum = std::max(maximum, other.maximum);
+}
+
+void LatencyHistogram::subtract(const LatencyHistogram &other)
+{
+    for (std::size_t i = 0; i < other.buckets.size() && i < buckets.size(); ++i) {
+        buckets[i] -= std::min(buckets[i], other.buckets[i]);
+    }
+    total -= std::min(total, other.total);
+    sum -= std::min(sum, other.sum);
+
+    while (!buckets.empty() && buckets.back() == 0) {
+        buckets.pop_back();
+    }
+    maximum = buckets.empty() ? 0 : std::min(maximum, highestValueOf(buckets.size() - 1));
+}
+
+int LatencyHistogram::percentile(double percentile) const
+{
+    if (total == 0) {
+        return 0;
+    }
+
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * total)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(highestValueOf(i), maximum);
+        }
+    }
+    return maximum;
+}
+
+void LatencyHistogram::assign(const std::vector<std::uint64_t> &counts, std::uint64_t valueSum, int valueMaximum)
+{
+    buckets = counts;
+    total = 0;
+    for (std::uint64_t count : buckets) {
+        total += count;
+    }
+    sum = valueSum;
+    maximum = std::max(valueMaximum, 0);
+}
@@ -0,0 +1,54 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The LatencyHistogram class counts non-negative latencies (in time steps) in log-linear buckets, like an
+ *        HDR histogram:
+ *        - Values below subBucketCount have a bucket each, so short latencies are exact
+ *        - Every power of two above is split in subBucketCount buckets, a percentile is off by at most 1/32
+ *        - Recording is a few shifts and one increment, the buckets only grow up to the largest value recorded,
+ *          at most 864 of them for any int
+ *        The count, sum and maximum are exact
+ */
+class LatencyHistogram
+{
+public:
+    static const int subBucketBits = 5;
+    static const int subBucketCount = 1 << subBucketBits;
+
+    LatencyHistogram();
+
+    void record(int value);
+
+    // Adds or removes the values of other, other's values must have been recorded here before removing them.
+    // After a removal the maximum is the highest value of the highest bucket left, rounded like a percentile
+    void add(const LatencyHistogram &other);
+    void subtract(const LatencyHistogram &other);
+
+    std::uint64_t count() const { return total; }
+    double mean() const { return total > 0 ? static_cast<double>(sum) / total : 0.0; }
+    int max() const { return maximum; }
+
+    // Highest value of the bucket holding the percentile-th value (0 < percentile <= 100), 0 if empty
+    int percentile(double percentile) const;
+
+    // Buckets and exact sums, for the checkpoint file
+    const std::vector<std::uint64_t> &getBuckets() const { return buckets; }
+    std::uint64_t getSum() const { return sum; }
+    void assign(const std::vector<std::uint64_t> &buckets, std::uint64_t sum, int maximum);
+
+    static std::size_t bucketOf(int value);
+    static int highestValueOf(std::size_t bucket);
+
+private:
+    std::vector<std::uint64_t> buckets;
+    std::uint64_t total;
+    std::uint64_t sum;
+    int maximum;
+};
+
+#endif // LATENCYHISTOGRAM_H
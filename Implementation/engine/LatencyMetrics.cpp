@@ -0,0 +1,197 @@
+#include "LatencyMetrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+const LatencyHistogram emptyHistogram;
+
+std::string meanText(double mean)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f", mean);
+    return text;
+}
+
+}
+
+LatencyMetrics::LatencyMetrics()
+{
+}
+
+void LatencyMetrics::recordWait(int floor, int carId, int timeSteps)
+{
+    writable(All, 0, Wait).record(timeSteps);
+    writable(Floor, floor, Wait).record(timeSteps);
+    writable(Car, carId, Wait).record(timeSteps);
+}
+
+void LatencyMetrics::recordExit(int floor, int carId, int rideSteps, int journeySteps)
+{
+    writable(All, 0, Ride).record(rideSteps);
+    writable(Floor, floor, Ride).record(rideSteps);
+    writable(Car, carId, Ride).record(rideSteps);
+    writable(All, 0, Journey).record(journeySteps);
+    writable(Floor, floor, Journey).record(journeySteps);
+    writable(Car, carId, Journey).record(journeySteps);
+}
+
+const LatencyHistogram &LatencyMetrics::histogram(Scope scope, int key, Kind kind) const
+{
+    const LatencyHistogram *found = nullptr;
+    if (scope == All) {
+        found = all[kind].get();
+    } else if (key >= 0 && static_cast<std::size_t>(key) < histogramsOf(scope).size()) {
+        found = histogramsOf(scope)[key][kind].get();
+    }
+    return found ? *found : emptyHistogram;
+}
+
+std::size_t LatencyMetrics::keyCount(Scope scope) const
+{
+    return scope == All ? 1 : histogramsOf(scope).size();
+}
+
+void LatencyMetrics::add(const LatencyMetrics &other)
+{
+    for (Scope scope : {All, Floor, Car}) {
+        for (std::size_t key = 0; key < other.keyCount(scope); ++key) {
+            for (int kind = 0; kind < KindCount; ++kind) {
+                const LatencyHistogram &values = other.histogram(scope, static_cast<int>(key), Kind(kind));
+                if (values.count() > 0) {
+                    writable(scope, static_cast<int>(key), Kind(kind)).add(values);
+                }
+            }
+        }
+    }
+}
+
+void LatencyMetrics::subtract(const LatencyMetrics &other)
+{
+    for (Scope scope : {All, Floor, Car}) {
+        for (std::size_t key = 0; key < other.keyCount(scope) && key < keyCount(scope); ++key) {
+            for (int kind = 0; kind < KindCount; ++kind) {
+                const LatencyHistogram &values = other.histogram(scope, static_cast<int>(key), Kind(kind));
+                if (values.count() > 0 && histogram(scope, static_cast<int>(key), Kind(kind)).count() > 0) {
+                    writable(scope, static_cast<int>(key), Kind(kind)).subtract(values);
+                }
+            }
+        }
+    }
+}
+
+void LatencyMetrics::writeCsv(std::ostream &out) const
+{
+    out << "scope,key,metric,count,mean,p50,p90,p99,max\n";
+    for (Scope scope : {All, Floor, Car}) {
+        for (std::size_t key = 0; key < keyCount(scope); ++key) {
+            for (int kind = 0; kind < KindCount; ++kind) {
+                const LatencyHistogram &values = histogram(scope, static_cast<int>(key), Kind(kind));
+                if (values.count() == 0) {
+                    continue;
+                }
+                out << scopeName(scope) << ',' << (scope == All ? std::string() : std::to_string(key)) << ','
+                    << kindName(Kind(kind)) << ',' << values.count() << ',' << meanText(values.mean()) << ','
+                    << values.percentile(50) << ',' << values.percentile(90) << ',' << values.percentile(99) << ','
+                    << values.max() << '\n';
+            }
+        }
+    }
+}
+
+bool LatencyMetrics::saveCsv(const std::string &path, std::string &error) const
+{
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::trunc);
+        if (out) {
+            writeCsv(out);
+        }
+        if (!out || !out.flush()) {
+            error = "cannot write " + temporaryPath;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> LatencyMetrics::summary() const
+{
+    std::vector<std::string> lines;
+    for (int kind = 0; kind < KindCount; ++kind) {
+        const LatencyHistogram &values = histogram(All, 0, Kind(kind));
+        std::string name = kindName(Kind(kind));
+        name[0] = static_cast<char>(name[0] - 'a' + 'A');
+        lines.push_back(name + " p50 " + std::to_string(values.percentile(50))
+                        + " s, p90 " + std::to_string(values.percentile(90))
+                        + " s, p99 " + std::to_string(values.percentile(99))
+                        + " s, max " + std::to_string(values.max())
+                        + " s (" + std::to_string(values.count()) + " recorded)");
+    }
+    return lines;
+}
+
+const char *LatencyMetrics::kindName(Kind kind)
+{
+    switch (kind) {
+    case Wait:
+        return "wait";
+    case Ride:
+        return "ride";
+    case Journey:
+        return "journey";
+    default:
+        return "";
+    }
+}
+
+const char *LatencyMetrics::scopeName(Scope scope)
+{
+    switch (scope) {
+    case All:
+        return "all";
+    case Floor:
+        return "floor";
+    case Car:
+        return "car";
+    default:
+        return "";
+    }
+}
+
+void LatencyMetrics::assign(Scope scope, int key, Kind kind, const LatencyHistogram &histogram)
+{
+    writable(scope, key, kind) = histogram;
+}
+
+/**
+ * @brief Allocates the histogram or unshares it from the copies of the metrics first
+ */
+LatencyHistogram &LatencyMetrics::writable(Scope scope, int key, Kind kind)
+{
+    std::shared_ptr<LatencyHistogram> *slot = &all[kind];
+    if (scope != All) {
+        std::vector<Histograms> &histograms = scope == Floor ? floors : cars;
+        const std::size_t index = static_cast<std::size_t>(std::max(key, 0));
+        if (index >= histograms.size()) {
+            histograms.resize(index + 1);
+        }
+        slot = &histograms[index][kind];
+    }
+
+    if (!*slot) {
+        *slot = std::make_shared<LatencyHistogram>();
+    } else if (slot->use_count() > 1) {
+        *slot = std::make_shared<LatencyHistogram>(**slot);
+    }
+    return **slot;
+}
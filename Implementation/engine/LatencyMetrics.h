@@ -0,0 +1,73 @@
+#ifndef LATENCYMETRICS_H
+#define LATENCYMETRICS_H
+
+#include "LatencyHistogram.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The LatencyMetrics class keeps the latency distributions of the completed journeys:
+ *        - Wait, from the hall call to boarding, recorded at boarding
+ *        - Ride, from boarding to the exit, and journey, from the hall call to the exit, recorded at the exit
+ *        Each is kept for the whole bank, per origin floor and per car, so percentiles can be read for any of them.
+ *        Histograms are shared between copies and copied on write, a copy for a checkpoint costs one pointer each
+ */
+class LatencyMetrics
+{
+public:
+    enum Kind {
+        Wait,
+        Ride,
+        Journey,
+        KindCount
+    };
+
+    enum Scope {
+        All,
+        Floor,
+        Car
+    };
+
+    using Histograms = std::array<std::shared_ptr<LatencyHistogram>, KindCount>;
+
+    LatencyMetrics();
+
+    void recordWait(int floor, int carId, int timeSteps);
+    void recordExit(int floor, int carId, int rideSteps, int journeySteps);
+
+    // The histogram of the floor or car number, an empty one if nothing was recorded for it. key is ignored for All
+    const LatencyHistogram &histogram(Scope scope, int key, Kind kind) const;
+    // One past the highest floor or car number recorded
+    std::size_t keyCount(Scope scope) const;
+
+    // Adds or removes every histogram of other, see LatencyHistogram
+    void add(const LatencyMetrics &other);
+    void subtract(const LatencyMetrics &other);
+
+    // Writes "scope,key,metric,count,mean,p50,p90,p99,max" rows, every histogram with a value
+    void writeCsv(std::ostream &out) const;
+    // Writes the CSV rows to a temporary file then renames it over path, so a reader never sees half a report
+    bool saveCsv(const std::string &path, std::string &error) const;
+    // One line per kind for the whole bank, e.g. "Wait p50 12 s, p90 30 s, p99 41 s, max 45 s (120 recorded)"
+    std::vector<std::string> summary() const;
+
+    static const char *kindName(Kind kind);
+    static const char *scopeName(Scope scope);
+
+    // Replaces a histogram, for the checkpoint file
+    void assign(Scope scope, int key, Kind kind, const LatencyHistogram &histogram);
+
+private:
+    const std::vector<Histograms> &histogramsOf(Scope scope) const { return scope == Floor ? floors : cars; }
+    LatencyHistogram &writable(Scope scope, int key, Kind kind);
+
+    Histograms all;
+    std::vector<Histograms> floors;     // By floor number, null until a journey from the floor is recorded
+    std::vector<Histograms> cars;       // By car ID
+};
+
+#endif // LATENCYMETRICS_H
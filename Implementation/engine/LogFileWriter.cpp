@@ -0,0 +1,323 @@
+#include "LogFileWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef ELEVATOR_SIM_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Longest a line waits in the queue before the writer takes it
+const std::chrono::milliseconds flushInterval(10);
+
+#ifdef ELEVATOR_SIM_WITH_ZLIB
+// Writes source to target as gzip and removes source, source is kept if anything fails
+bool compressFile(const std::string &source, const std::string &target, std::string &error)
+{
+    std::ifstream in(source, std::ios::binary);
+    gzFile out = in ? gzopen(target.c_str(), "wb6") : nullptr;
+    if (!out) {
+        error = "Cannot compress " + source + " to " + target;
+        return false;
+    }
+
+    std::vector<char> buffer(1 << 16);
+    bool written = true;
+    while (written && in) {
+        in.read(buffer.data(), buffer.size());
+        const std::streamsize size = in.gcount();
+        written = size == 0 || gzwrite(out, buffer.data(), static_cast<unsigned>(size)) == size;
+    }
+    written = gzclose(out) == Z_OK && written && in.eof();
+    in.close();
+    if (!written) {
+        std::remove(target.c_str());
+        error = "Cannot compress " + source + " to " + target;
+        return false;
+    }
+    std::remove(source.c_str());
+    return true;
+}
+#endif
+
+// rename() does not replace an existing file on Windows
+bool replaceFile(const std::string &from, const std::string &to)
+{
+    std::remove(to.c_str());
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+}
+
+LogFileWriter::LogFileWriter()
+    : fileBytes(0),
+      closing(true),
+      droppedSinceBatch(0),
+      writtenCount(0),
+      droppedCount(0),
+      rotationCount(0)
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    std::string error;
+    close(error);
+}
+
+bool LogFileWriter::hasCompression()
+{
+#ifdef ELEVATOR_SIM_WITH_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Opens the log file and starts the writer thread
+ * @param options The file, its rotation and what to do when the queue is full
+ * @param error Set when false is returned
+ * @return False if the options are invalid or the file can't be created
+ */
+bool LogFileWriter::open(const Options &options, std::string &error)
+{
+    if (isOpen()) {
+        error = "The log file is already open";
+        return false;
+    }
+    if (options.path.empty()) {
+        error = "No log file path";
+        return false;
+    }
+    if (options.compress && !hasCompression()) {
+        error = "Log file compression needs a build with ELEVATOR_SIM_WITH_ZLIB";
+        return false;
+    }
+    if (options.queueCapacity < 1 || options.maxFiles < 0) {
+        error = "Invalid log file queue capacity or file count";
+        return false;
+    }
+
+    file.open(options.path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "Cannot create " + options.path;
+        return false;
+    }
+
+    this->options = options;
+    fileBytes = 0;
+    queue.clear();
+    queue.reserve(options.queueCapacity);
+    droppedSinceBatch = 0;
+    firstError.clear();
+    writtenCount = 0;
+    droppedCount = 0;
+    rotationCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = false;
+    }
+    writerThread = std::thread(&LogFileWriter::run, this);
+    return true;
+}
+
+bool LogFileWriter::close(std::string &error)
+{
+    if (!isOpen()) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    notEmpty.notify_one();
+    notFull.notify_all();
+    writerThread.join();
+    file.close();
+
+    if (!firstError.empty()) {
+        error = firstError;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Queues a line for the writer thread. The caller never waits on the file, only on a full queue under
+ *        the Block policy or for a line at or above keepLevel
+ * @return False if the line was dropped or the writer is closed
+ */
+bool LogFileWriter::write(SimulationLog::Category category, SimulationLog::Level level, const std::string &message)
+{
+    // Copied before the lock so producers only hold it for the move
+    Line line{category, level, message};
+    const bool droppable = options.overflow == DropLowSeverity && level < options.keepLevel;
+    const std::size_t capacity = static_cast<std::size_t>(options.queueCapacity);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (closing) {
+        return false;
+    }
+    if (droppable && queue.size() >= capacity - capacity / 4) {
+        ++droppedSinceBatch;
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (queue.size() >= capacity) {
+        notFull.wait(lock, [this, capacity]() { return closing || queue.size() < capacity; });
+        if (closing) {
+            return false;
+        }
+    }
+
+    // The writer wakes up on its own every flushInterval, it is only woken early for a filling queue
+    queue.push_back(std::move(line));
+    const bool wakeWriter = queue.size() == wakeThreshold();
+    lock.unlock();
+    if (wakeWriter) {
+        notEmpty.notify_one();
+    }
+    return true;
+}
+
+/**
+ * @brief The writer thread: takes the whole queue every flushInterval, or once it fills up, leaving the producers
+ *        an empty one, and writes it without holding the lock. Ends once closing is set and the queue is written.
+ *        Taking lines in batches keeps the producers from waking the writer, a system call, for every line
+ */
+void LogFileWriter::run()
+{
+    std::vector<Line> batch;
+    batch.reserve(options.queueCapacity);
+    for (;;) {
+        std::uint64_t dropped = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            notEmpty.wait_for(lock, flushInterval, [this]() {
+                return closing || queue.size() >= wakeThreshold() || droppedSinceBatch > 0;
+            });
+            if (closing && queue.empty() && droppedSinceBatch == 0) {
+                break;
+            }
+            if (queue.empty() && droppedSinceBatch == 0) {
+                continue;
+            }
+            batch.swap(queue);
+            dropped = droppedSinceBatch;
+            droppedSinceBatch = 0;
+        }
+        notFull.notify_all();
+
+        writeBatch(batch, dropped);
+        batch.clear();
+    }
+    file.flush();
+}
+
+void LogFileWriter::writeBatch(const std::vector<Line> &batch, std::uint64_t dropped)
+{
+    std::string text;
+    if (dropped > 0) {
+        text = "[warning] [lifecycle] " + std::to_string(dropped) + " log lines dropped, the disk fell behind\n";
+        append(text);
+    }
+
+    for (const Line &line : batch) {
+        text.clear();
+        text += '[';
+        text += SimulationLog::levelName(line.level);
+        text += "] [";
+        text += SimulationLog::categoryName(line.category);
+        text += "] ";
+        text += line.message;
+        text += '\n';
+        append(text);
+    }
+    file.flush();
+    writtenCount.fetch_add(batch.size(), std::memory_order_relaxed);
+}
+
+void LogFileWriter::append(const std::string &text)
+{
+    if (!file.is_open()) {
+        return;
+    }
+    if (options.maxFileBytes > 0 && fileBytes > 0 && fileBytes + text.size() > options.maxFileBytes) {
+        rotate();
+        if (!file.is_open()) {
+            return;
+        }
+    }
+
+    if (!file.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+        fail("Cannot write " + options.path);
+        file.close();
+        return;
+    }
+    fileBytes += text.size();
+}
+
+/**
+ * @brief Moves path.N to path.N+1 from the oldest file down, path to path.1, and starts a new path
+ */
+void LogFileWriter::rotate()
+{
+    file.close();
+
+    if (options.maxFiles > 0) {
+        // A file that could not be compressed kept its plain name, it moves up and is removed with the others
+        for (bool compressed : {false, true}) {
+            if (compressed && !options.compress) {
+                continue;
+            }
+            std::remove(rotatedPath(options.maxFiles, compressed).c_str());
+            for (int number = options.maxFiles - 1; number >= 1; --number) {
+                std::rename(rotatedPath(number, compressed).c_str(), rotatedPath(number + 1, compressed).c_str());
+            }
+        }
+
+        const std::string firstPath = rotatedPath(1, false);
+        if (!replaceFile(options.path, firstPath)) {
+            fail("Cannot rename " + options.path + " to " + firstPath);
+        }
+#ifdef ELEVATOR_SIM_WITH_ZLIB
+        else if (options.compress) {
+            // A file that can't be compressed is kept as it is
+            std::string error;
+            if (!compressFile(firstPath, rotatedPath(1, true), error)) {
+                fail(error);
+            }
+        }
+#endif
+    }
+
+    file.open(options.path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        fail("Cannot create " + options.path);
+        file.close();
+    }
+    fileBytes = 0;
+    rotationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::size_t LogFileWriter::wakeThreshold() const
+{
+    return std::max<std::size_t>(1, static_cast<std::size_t>(options.queueCapacity) / 8);
+}
+
+std::string LogFileWriter::rotatedPath(int number, bool compressed) const
+{
+    return options.path + "." + std::to_string(number) + (compressed ? ".gz" : "");
+}
+
+void LogFileWriter::fail(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (firstError.empty()) {
+        firstError = message;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef LOGFILEWRITER_H
+#define LOGFILEWRITER_H
+
+#include "SimulationLog.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The LogFileWriter class is responsible for writing the simulation log to disk without stalling it:
+ *        - write() only appends the line to a bounded queue shared by every producer thread, a background
+ *          thread takes the whole queue at once and writes it to the file, so no producer ever waits on I/O.
+ *          The writer takes the queue every few milliseconds, or as soon as it is an eighth full
+ *        - Once the file reaches maxFileBytes it is renamed path.1 (path.1.gz when compressed), the older
+ *          files move up one number and the ones past maxFiles are removed. A file that fails to compress is
+ *          kept as path.N, reported by close(), and moves up like the others
+ *        - When the disk can't keep up and the queue fills, DropLowSeverity drops the lines below keepLevel
+ *          once the queue is three quarters full, so the rest of the queue stays free for the important ones,
+ *          and the file notes how many were dropped. Lines at keepLevel and above are never dropped, on a full
+ *          queue their producer waits for room. Block makes every producer wait for room instead
+ *        Compression uses zlib and needs a build with ELEVATOR_SIM_WITH_ZLIB
+ */
+class LogFileWriter
+{
+public:
+    enum OverflowPolicy {
+        Block,              // Producers wait for room in the queue, no line is lost
+        DropLowSeverity     // Lines below keepLevel are dropped while the queue is nearly full
+    };
+
+    struct Options {
+        std::string path;
+        std::uint64_t maxFileBytes = 64 * 1024 * 1024;  // 0 never rotates
+        int maxFiles = 5;                               // Rotated files kept, 0 only keeps the current one
+        bool compress = false;                          // Gzip the rotated files
+        int queueCapacity = 65536;                      // Lines waiting for the writer thread
+        OverflowPolicy overflow = DropLowSeverity;
+        SimulationLog::Level keepLevel = SimulationLog::Warning;  // Lowest level DropLowSeverity never drops, it waits
+    };
+
+    LogFileWriter();
+    ~LogFileWriter();
+
+    LogFileWriter(const LogFileWriter &) = delete;
+    LogFileWriter &operator=(const LogFileWriter &) = delete;
+
+    // Replaces the file at options.path and starts the writer thread
+    bool open(const Options &options, std::string &error);
+
+    // Writes the queued lines, stops the writer thread and closes the file. False if a write, a rotation or a
+    // compression failed since open()
+    bool close(std::string &error);
+
+    bool isOpen() const { return writerThread.joinable(); }
+
+    // Queues a line, thread-safe. False if it was dropped or the writer is closed. Waits while the queue is full,
+    // under DropLowSeverity only for lines at keepLevel and above
+    bool write(SimulationLog::Category category, SimulationLog::Level level, const std::string &message);
+
+    // Lines written to disk, dropped by DropLowSeverity, and files rotated so far
+    std::uint64_t getWrittenCount() const { return writtenCount.load(std::memory_order_relaxed); }
+    std::uint64_t getDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+    int getRotationCount() const { return rotationCount.load(std::memory_order_relaxed); }
+
+    // True if the build can compress the rotated files
+    static bool hasCompression();
+
+private:
+    struct Line {
+        SimulationLog::Category category;
+        SimulationLog::Level level;
+        std::string message;
+    };
+
+    void run();
+    void writeBatch(const std::vector<Line> &batch, std::uint64_t dropped);
+    // Writes text to the file, rotating it first if text would take it past maxFileBytes
+    void append(const std::string &text);
+    void rotate();
+    // Queued lines that wake the writer before its next flush
+    std::size_t wakeThreshold() const;
+    // path.number, with .gz for a compressed file
+    std::string rotatedPath(int number, bool compressed) const;
+    void fail(const std::string &message);
+
+    Options options;
+    std::ofstream file;
+    std::uint64_t fileBytes;
+    std::thread writerThread;
+
+    // Guards the queue, closing, droppedSinceBatch and firstError
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::vector<Line> queue;
+    bool closing;                     // True while the writer is not open
+    std::uint64_t droppedSinceBatch;  // Lines dropped since the writer last took the queue
+    std::string firstError;
+
+    std::atomic<std::uint64_t> writtenCount;
+    std::atomic<std::uint64_t> droppedCount;
+    std::atomic<int> rotationCount;
+};
+
+#endif // LOGFILEWRITER_H
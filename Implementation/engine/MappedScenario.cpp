@@ -0,0 +1,309 @@
+#include "MappedScenario.h"
+#include "ActionTable.h"
+#include "SimulationConfig.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char fileMagic[8] = {'E', 'L', 'V', 'S', 'C', 'E', 'N', '\0'};
+const std::uint32_t fileVersion = 3;
+// Version 2 files have no highestPassengerId, their header is 8 bytes shorter
+const std::uint32_t shortHeaderVersion = 2;
+// Version 1 files have one time step per safety event kind in the header and no event list either
+const std::uint32_t legacyFileVersion = 1;
+const std::size_t shortHeaderSize = offsetof(ScenarioHeader, highestPassengerId);
+
+// Records written per call to the output stream
+const std::size_t writeBatch = 65536;
+
+bool fitsFloor(int floor)
+{
+    return floor >= INT16_MIN && floor <= INT16_MAX;
+}
+
+}
+
+MappedScenario::~MappedScenario()
+{
+    if (!mapping) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, mappingSize);
+#endif
+}
+
+/**
+ * @brief Maps the whole file read-only, nothing is read until the records are accessed
+ * @param path The binary scenario
+ * @param error Set to the reason the file was rejected
+ * @return The mapping, null on error
+ */
+std::shared_ptr<const MappedScenario> MappedScenario::open(const std::string &path, std::string &error)
+{
+    std::shared_ptr<MappedScenario> scenario(new MappedScenario());
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE fileMapping = fileSize.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!fileMapping) {
+        error = "cannot map " + path;
+        return nullptr;
+    }
+    scenario->mapping = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(fileMapping);
+    scenario->mappingSize = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        error = "cannot open " + path;
+        return nullptr;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0) {
+        ::close(file);
+        error = "cannot map " + path;
+        return nullptr;
+    }
+    void *mapping = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (mapping != MAP_FAILED) {
+        scenario->mapping = mapping;
+        scenario->mappingSize = static_cast<std::size_t>(status.st_size);
+        // Read ahead of the cursor and let the kernel reclaim the pages behind it early
+        madvise(mapping, scenario->mappingSize, MADV_SEQUENTIAL);
+    }
+#endif
+    if (!scenario->mapping) {
+        error = "cannot map " + path;
+        return nullptr;
+    }
+
+    if (scenario->mappingSize < shortHeaderSize) {
+        error = path + " is not a binary scenario";
+        return nullptr;
+    }
+    // Copied, so the fields an older header lacks can be filled in
+    ScenarioHeader &header = scenario->fileHeader;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(&header, scenario->mapping, shortHeaderSize);
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0) {
+        error = path + " is not a binary scenario";
+        return nullptr;
+    }
+    if ((header.version != fileVersion && header.version != shortHeaderVersion && header.version != legacyFileVersion)
+        || header.recordSize != sizeof(ScenarioRecord)) {
+        error = path + " has an unsupported version";
+        return nullptr;
+    }
+    const std::size_t headerSize = header.version == fileVersion ? sizeof(ScenarioHeader) : shortHeaderSize;
+    if (scenario->mappingSize < headerSize) {
+        error = path + " is truncated";
+        return nullptr;
+    }
+    std::memcpy(&header, scenario->mapping, headerSize);
+
+    const std::uint64_t eventCount = header.version == legacyFileVersion ? 0 : header.safetyEventCount;
+    const std::uint64_t bodySize = scenario->mappingSize - headerSize;
+    if (header.recordCount > bodySize / sizeof(ScenarioRecord) ||
+        eventCount > (bodySize - header.recordCount * sizeof(ScenarioRecord)) / sizeof(ScenarioSafetyEvent)) {
+        error = path + " is truncated";
+        return nullptr;
+    }
+
+    scenario->records = reinterpret_cast<const ScenarioRecord *>(static_cast<const char *>(scenario->mapping)
+                                                                 + headerSize);
+    if (header.version != fileVersion) {
+        // Reads every record once, a version 3 file stores the ID
+        for (std::uint64_t i = 0; i < header.recordCount; ++i) {
+            header.highestPassengerId = std::max(header.highestPassengerId, scenario->records[i].passengerId);
+        }
+    }
+    return scenario;
+}
+
+/**
+ * @brief Sorts and matches the actions the same way the engine schedules and pairs them, then writes them out
+ */
+bool MappedScenario::write(const std::string &path, const SimulationConfig &config, std::string &error)
+{
+    const ActionTable &actions = *config.actions;
+
+    // Stable, so actions of the same time step keep the order the engine's calendar gives them
+    std::vector<std::uint32_t> order(actions.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&actions](std::uint32_t a, std::uint32_t b) {
+        return actions.timeStepAt(a) < actions.timeStepAt(b);
+    });
+
+    std::vector<ScenarioRecord> records(order.size());
+    std::unordered_map<int, std::deque<std::size_t>> exitsByPassenger;
+    std::int32_t highestPassengerId = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const PassengerAction action = actions.at(order[i]);
+        if (!fitsFloor(action.floor)) {
+            error = "floor " + std::to_string(action.floor) + " does not fit a binary scenario";
+            return false;
+        }
+
+        ScenarioRecord &record = records[i];
+        std::memset(&record, 0, sizeof(record));
+        record.timeStep = action.timeStep;
+        record.passengerId = action.passengerId;
+        record.floor = static_cast<std::int16_t>(action.floor);
+        record.type = action.actionType;
+        highestPassengerId = std::max(highestPassengerId, action.passengerId);
+        if (action.actionType == PassengerAction::ExitCar) {
+            exitsByPassenger[action.passengerId].push_back(i);
+        }
+    }
+
+    // A request takes the passenger's first exit at or after it, as SimulationEngine::takePairedExitFloor does
+    for (ScenarioRecord &record : records) {
+        if (record.type != PassengerAction::RequestCar) {
+            continue;
+        }
+        auto found = exitsByPassenger.find(record.passengerId);
+        if (found == exitsByPassenger.end()) {
+            continue;
+        }
+
+        std::deque<std::size_t> &exits = found->second;
+        while (!exits.empty() && records[exits.front()].timeStep < record.timeStep) {
+            exits.pop_front();
+        }
+        if (!exits.empty()) {
+            ScenarioRecord &exit = records[exits.front()];
+            exits.pop_front();
+            exit.flags |= ScenarioRecord::Matched;
+            exit.matchedFloor = exit.floor;
+            record.flags |= ScenarioRecord::Matched;
+            record.matchedFloor = exit.floor;
+        }
+    }
+
+    ScenarioHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.recordSize = sizeof(ScenarioRecord);
+    header.passengerCount = config.passengerCount;
+    header.floorCount = config.floorCount;
+    header.elevatorCount = config.elevatorCount;
+    header.dispatchPolicy = config.dispatchPolicy;
+    header.seed = config.seed;
+    std::fill(std::begin(header.legacySafetyTimeSteps), std::end(header.legacySafetyTimeSteps), -1);
+    header.safetyEventCount = static_cast<std::uint32_t>(config.safetyEvents.size());
+    header.recordCount = records.size();
+    header.highestPassengerId = highestPassengerId;
+
+    std::vector<ScenarioSafetyEvent> events(config.safetyEvents.size());
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const SafetyEvent &event = config.safetyEvents[i];
+        events[i] = ScenarioSafetyEvent{event.kind, event.timeStep, event.target, 0};
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (std::size_t first = 0; first < records.size() && out; first += writeBatch) {
+        std::size_t count = std::min(writeBatch, records.size() - first);
+        out.write(reinterpret_cast<const char *>(&records[first]),
+                  static_cast<std::streamsize>(count * sizeof(ScenarioRecord)));
+    }
+    out.write(reinterpret_cast<const char *>(events.data()),
+              static_cast<std::streamsize>(events.size() * sizeof(ScenarioSafetyEvent)));
+    if (!out.flush()) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+void MappedScenario::applyTo(SimulationConfig &config) const
+{
+    const ScenarioHeader &header = fileHeader;
+    config.passengerCount = header.passengerCount;
+    config.floorCount = header.floorCount;
+    config.elevatorCount = header.elevatorCount;
+    config.dispatchPolicy = header.dispatchPolicy >= 0 && header.dispatchPolicy < Dispatcher::PolicyCount
+                          ? static_cast<Dispatcher::Policy>(header.dispatchPolicy) : Dispatcher::Collective;
+    config.seed = header.seed;
+    config.safetyEvents = safetyEvents();
+}
+
+/**
+ * @brief Reads the safety events following the records, or the header's time steps of a version 1 file.
+ *        Events of an unknown kind are skipped
+ */
+std::vector<SafetyEvent> MappedScenario::safetyEvents() const
+{
+    const ScenarioHeader &header = fileHeader;
+    std::vector<SafetyEvent> events;
+    if (header.version == legacyFileVersion) {
+        for (int kind = 0; kind < SafetyEvent::KindCount; ++kind) {
+            if (header.legacySafetyTimeSteps[kind] >= 0) {
+                events.emplace_back(static_cast<SafetyEvent::Kind>(kind), header.legacySafetyTimeSteps[kind]);
+            }
+        }
+        return events;
+    }
+
+    // The records are 16 bytes, so the events after them stay aligned
+    const ScenarioSafetyEvent *stored = reinterpret_cast<const ScenarioSafetyEvent *>(records + header.recordCount);
+    for (std::uint32_t i = 0; i < header.safetyEventCount; ++i) {
+        if (stored[i].kind >= 0 && stored[i].kind < SafetyEvent::KindCount) {
+            events.emplace_back(static_cast<SafetyEvent::Kind>(stored[i].kind), stored[i].timeStep, stored[i].target);
+        }
+    }
+    return events;
+}
+
+/**
+ * @brief Releases the pages from the one holding record first up to the last whole page before record last.
+ *        Callers release the records they are done with in order, so a page is only dropped once every record
+ *        on it was read. The mapping is read-only and backed by the file, so nothing is lost
+ */
+void MappedScenario::release(std::uint64_t first, std::uint64_t last) const
+{
+#ifdef _WIN32
+    // Windows trims the working set of a read-only file view on its own
+    (void)first;
+    (void)last;
+#else
+    static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+    const std::size_t begin = reinterpret_cast<std::size_t>(records + first);
+    const std::size_t end = reinterpret_cast<std::size_t>(records + std::min(last, size()));
+    const std::size_t alignedBegin = begin / pageSize * pageSize;
+    const std::size_t alignedEnd = end / pageSize * pageSize;
+    if (alignedBegin < alignedEnd) {
+        madvise(reinterpret_cast<void *>(alignedBegin), alignedEnd - alignedBegin, MADV_DONTNEED);
+    }
+#endif
+}
@@ -0,0 +1,117 @@
+#ifndef MAPPEDSCENARIO_H
+#define MAPPEDSCENARIO_H
+
+#include "PassengerAction.h"
+#include "SafetyEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct SimulationConfig;
+
+/**
+ * @brief The ScenarioRecord struct is one passenger action of a binary scenario, 16 bytes on disk and in memory.
+ *        Car requests already carry their destination, so the engine never has to look ahead in the file
+ */
+struct ScenarioRecord {
+    enum Flags : std::uint8_t {
+        Matched = 1   // RequestCar: matchedFloor is its destination. ExitCar: the exit belongs to a car request
+    };
+
+    std::int32_t timeStep;
+    std::int32_t passengerId;
+    std::int16_t floor;
+    std::int16_t matchedFloor;
+    std::uint8_t type;         // PassengerAction::Type
+    std::uint8_t flags;
+    std::uint16_t reserved;
+
+    PassengerAction action() const {
+        return PassengerAction(static_cast<PassengerAction::Type>(type), floor, timeStep, passengerId);
+    }
+};
+
+static_assert(sizeof(ScenarioRecord) == 16, "ScenarioRecord is a 16 byte file record");
+
+/**
+ * @brief The ScenarioSafetyEvent struct is one safety event of a binary scenario, the events follow the records
+ */
+struct ScenarioSafetyEvent {
+    std::int32_t kind;         // SafetyEvent::Kind
+    std::int32_t timeStep;
+    std::int32_t target;
+    std::int32_t reserved;
+};
+
+static_assert(sizeof(ScenarioSafetyEvent) == 16, "ScenarioSafetyEvent is a 16 byte file record");
+
+/**
+ * @brief The ScenarioHeader struct starts a binary scenario file, the records follow it sorted by time step,
+ *        then the safety events in list order. Files before version 3 end the header at recordCount
+ */
+struct ScenarioHeader {
+    char magic[8];             // "ELVSCEN\0"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::int32_t passengerCount;
+    std::int32_t floorCount;
+    std::int32_t elevatorCount;
+    std::int32_t dispatchPolicy;
+    std::uint64_t seed;
+    std::int32_t legacySafetyTimeSteps[5]; // Version 1 only: time step of each safety event kind, -1 if none
+    std::uint32_t safetyEventCount;        // Version 2: ScenarioSafetyEvents after the records
+    std::uint64_t recordCount;
+    std::int32_t highestPassengerId;       // Version 3: highest passenger ID of the records, 0 if none
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(ScenarioHeader) == 80, "ScenarioHeader is an 80 byte file header");
+
+/**
+ * @brief The MappedScenario class is responsible for:
+ *        - Writing a scenario as a compact binary file of time-sorted ScenarioRecords
+ *        - Memory-mapping such a file read-only, so the engine streams the actions straight from the page cache
+ *        - Letting the engine hand back the pages it has simulated past, so the resident memory of a run
+ *          stays bounded by the window being simulated however long the trace is
+ *        A mapping is immutable once opened and may be shared by engines on several threads
+ */
+class MappedScenario
+{
+public:
+    ~MappedScenario();
+
+    MappedScenario(const MappedScenario &) = delete;
+    MappedScenario &operator=(const MappedScenario &) = delete;
+
+    // Maps the file, returns null and sets error if it is missing or not a valid binary scenario
+    static std::shared_ptr<const MappedScenario> open(const std::string &path, std::string &error);
+
+    // Writes config (building, safety events and actions) as a binary scenario: the actions are stably sorted
+    // by time step and every car request is matched with the destination the engine would pair it with
+    static bool write(const std::string &path, const SimulationConfig &config, std::string &error);
+
+    // The header of an older file has highestPassengerId read from its records
+    const ScenarioHeader &header() const { return fileHeader; }
+    std::uint64_t size() const { return fileHeader.recordCount; }
+    const ScenarioRecord &at(std::uint64_t index) const { return records[index]; }
+    std::vector<SafetyEvent> safetyEvents() const;
+
+    // Copies the building, dispatch policy, seed and safety events of the file into config
+    void applyTo(SimulationConfig &config) const;
+
+    // Drops the pages of records [first, last) from the calling process, a page shared with record last is kept.
+    // Pages are read again from the file if accessed later
+    void release(std::uint64_t first, std::uint64_t last) const;
+
+private:
+    MappedScenario() = default;
+
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+    ScenarioHeader fileHeader{};
+    const ScenarioRecord *records = nullptr;
+};
+
+#endif // MAPPEDSCENARIO_H
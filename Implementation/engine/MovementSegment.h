@@ -0,0 +1,49 @@
+#ifndef MOVEMENTSEGMENT_H
+#define MOVEMENTSEGMENT_H
+
+#include <string>
+
+/**
+ * @brief The MovementSegment struct records one trip of a car from a stop to the next one:
+ *        - The car left fromFloor at startTimeStep and stopped at toFloor at endTimeStep
+ *        - It reached the first floor on its way at firstFloorTimeStep (after accelerating) and every further
+ *          floor floorTravelSteps later, the last one also takes the time to slow down
+ *        A trip costs the engine the same whatever its length, the per-floor "moving to floor" lines are only
+ *        formatted by a viewer that displays them, with floorMessage()
+ */
+struct MovementSegment {
+    int carId = 1;
+    int fromFloor = 1;
+    int toFloor = 1;
+    int startTimeStep = 0;
+    int firstFloorTimeStep = 0;
+    int floorTravelSteps = 1;
+    int endTimeStep = 0;
+
+    int floorCount() const { return toFloor > fromFloor ? toFloor - fromFloor : fromFloor - toFloor; }
+    int direction() const { return toFloor > fromFloor ? 1 : -1; }
+
+    // Floor reached after travelling floors floors, 1 to floorCount()
+    int floorAfter(int floors) const { return fromFloor + direction() * floors; }
+
+    // Time step the car reaches floorAfter(floors)
+    int timeStepAfter(int floors) const {
+        return floors >= floorCount() ? endTimeStep : firstFloorTimeStep + (floors - 1) * floorTravelSteps;
+    }
+
+    // Floor the car is at or heading to at timeStep, from startTimeStep to endTimeStep
+    int floorAt(int timeStep) const {
+        int floors = 1;
+        if (timeStep > firstFloorTimeStep) {
+            floors += (timeStep - firstFloorTimeStep + floorTravelSteps - 1) / floorTravelSteps;
+        }
+        return floorAfter(floors < floorCount() ? floors : floorCount());
+    }
+
+    // "Elevator 2 moving to floor 5...", the line of the car leaving for floorAfter(floors)
+    std::string floorMessage(int floors) const {
+        return "Elevator " + std::to_string(carId) + " moving to floor " + std::to_string(floorAfter(floors)) + "...";
+    }
+};
+
+#endif // MOVEMENTSEGMENT_H
@@ -0,0 +1,23 @@
+#include "PassengerAction.h"
+
+namespace {
+
+const char *const typeNames[] = {"RequestCar", "ExitCar", "OpenDoor", "CloseDoor", "PushHelp"};
+
+}
+
+const char *PassengerAction::typeName(Type type)
+{
+    return type <= PushHelp ? typeNames[type] : "Unknown";
+}
+
+bool PassengerAction::typeFromName(std::string_view name, Type &type)
+{
+    for (int i = RequestCar; i <= PushHelp; ++i) {
+        if (name == typeNames[i]) {
+            type = static_cast<Type>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,48 @@
+#ifndef PASSENGERACTION_H
+#define PASSENGERACTION_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief The PassengerAction struct Is a helper object for PassengerBehaviourSetup
+ *          - Allows the log console to accurately display custom passenger behaviour
+ *          - Is a 16 byte plain record so the engine dispatches on an enum instead of comparing strings
+ */
+struct PassengerAction {
+    enum Type : std::uint8_t {
+        RequestCar,
+        ExitCar,
+        OpenDoor,
+        CloseDoor,
+        PushHelp
+    };
+
+    Type actionType;           // The kind of action
+    std::int32_t floor;        // The floor associated with the action
+    std::int32_t timeStep;     // The time step associated with the action
+    std::int32_t passengerId;  // The passenger performing the action, 0 if unknown
+
+    PassengerAction() = default;
+    PassengerAction(Type type, int f, int ts, int id = 0)
+        : actionType(type), floor(f), timeStep(ts), passengerId(id) {}
+
+    // Name used by the log console and scenario text, e.g. "RequestCar"
+    static const char *typeName(Type type);
+
+    // Parses a name returned by typeName, returns false if the name is unknown
+    static bool typeFromName(std::string_view name, Type &type);
+};
+
+static_assert(sizeof(PassengerAction) <= 16, "PassengerAction must stay a 16 byte record");
+static_assert(std::is_trivially_copyable<PassengerAction>::value, "PassengerAction must stay trivially copyable");
+
+class ActionTable;
+
+// Immutable, shared action list, writers publish a new list instead of editing a published one (RCU-style)
+typedef std::shared_ptr<const ActionTable> PassengerActionSnapshot;
+
+#endif // PASSENGERACTION_H
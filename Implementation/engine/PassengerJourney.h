@@ -0,0 +1,29 @@
+#ifndef PASSENGERJOURNEY_H
+#define PASSENGERJOURNEY_H
+
+/**
+ * @brief The PassengerJourney struct follows one passenger from the hall call to the exit:
+ *        - Origin and destination floors
+ *        - The car serving the journey
+ *        - The time steps of the request, boarding and exit, used for the wait and ride time metrics
+ */
+struct PassengerJourney {
+    enum State {
+        Waiting,
+        Riding,
+        Done
+    };
+
+    int passengerId = 0;
+    int origin = 1;
+    int destination = 1;
+    int car = -1;             // Index of the car serving the journey
+    State state = Waiting;
+    int requestTimeStep = 0;
+    int boardTimeStep = -1;
+    int exitTimeStep = -1;
+
+    int direction() const { return destination > origin ? 1 : destination < origin ? -1 : 0; }
+};
+
+#endif // PASSENGERJOURNEY_H
@@ -0,0 +1,289 @@
+#include "PassengerTable.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+
+int rowOf(int passengerId)
+{
+    return passengerId % PassengerTable::blockSize;
+}
+
+}
+
+PassengerTable::Block::Block()
+{
+    origin.fill(0);
+    destination.fill(0);
+    car.fill(-1);
+    state.fill(Absent);
+    requestTimeStep.fill(-1);
+    boardTimeStep.fill(-1);
+    exitTimeStep.fill(-1);
+    completedBits.fill(0);
+}
+
+PassengerTable::PassengerTable()
+    : rowCount(0),
+      completed(0)
+{
+}
+
+/**
+ * @brief Starts a new journey of the passenger, an earlier journey's row is overwritten but the passenger stays completed
+ */
+void PassengerTable::request(int passengerId, int origin, int destination, int car, int timeStep)
+{
+    if (passengerId < 1) {
+        return;
+    }
+
+    Block &block = writableBlock(passengerId);
+    const int row = rowOf(passengerId);
+    block.origin[row] = static_cast<std::int16_t>(origin);
+    block.destination[row] = static_cast<std::int16_t>(destination);
+    block.car[row] = car;
+    block.state[row] = Waiting;
+    block.requestTimeStep[row] = timeStep;
+    block.boardTimeStep[row] = -1;
+    block.exitTimeStep[row] = -1;
+}
+
+void PassengerTable::board(int passengerId, int timeStep)
+{
+    if (passengerId < 1) {
+        return;
+    }
+
+    Block &block = writableBlock(passengerId);
+    block.state[rowOf(passengerId)] = Riding;
+    block.boardTimeStep[rowOf(passengerId)] = timeStep;
+}
+
+void PassengerTable::exit(int passengerId, int timeStep)
+{
+    if (passengerId < 1) {
+        return;
+    }
+
+    Block &block = writableBlock(passengerId);
+    const int row = rowOf(passengerId);
+    block.state[row] = Done;
+    block.exitTimeStep[row] = timeStep;
+
+    std::uint64_t &bits = block.completedBits[row / 64];
+    const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+    if (!(bits & bit)) {
+        bits |= bit;
+        ++completed;
+    }
+}
+
+void PassengerTable::clear()
+{
+    blocks.clear();
+    rowCount = 0;
+    completed = 0;
+}
+
+PassengerTable::State PassengerTable::stateOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? static_cast<State>(block->state[rowOf(passengerId)]) : Absent;
+}
+
+bool PassengerTable::isCompleted(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    const int row = rowOf(passengerId);
+    return block && (block->completedBits[row / 64] >> (row % 64)) & 1;
+}
+
+int PassengerTable::originOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->origin[rowOf(passengerId)] : 0;
+}
+
+int PassengerTable::destinationOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->destination[rowOf(passengerId)] : 0;
+}
+
+int PassengerTable::carOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->car[rowOf(passengerId)] : -1;
+}
+
+int PassengerTable::requestTimeStepOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->requestTimeStep[rowOf(passengerId)] : -1;
+}
+
+int PassengerTable::boardTimeStepOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->boardTimeStep[rowOf(passengerId)] : -1;
+}
+
+int PassengerTable::exitTimeStepOf(int passengerId) const
+{
+    const Block *block = blockOf(passengerId);
+    return block ? block->exitTimeStep[rowOf(passengerId)] : -1;
+}
+
+void PassengerTable::assign(int passengerId, State state, bool isCompleted, int origin, int destination, int car,
+                            int requestTimeStep, int boardTimeStep, int exitTimeStep)
+{
+    if (passengerId < 1) {
+        return;
+    }
+
+    Block &block = writableBlock(passengerId);
+    const int row = rowOf(passengerId);
+    block.origin[row] = static_cast<std::int16_t>(origin);
+    block.destination[row] = static_cast<std::int16_t>(destination);
+    block.car[row] = car;
+    block.state[row] = state;
+    block.requestTimeStep[row] = requestTimeStep;
+    block.boardTimeStep[row] = boardTimeStep;
+    block.exitTimeStep[row] = exitTimeStep;
+
+    std::uint64_t &bits = block.completedBits[row / 64];
+    const std::uint64_t bit = std::uint64_t(1) << (row % 64);
+    if (isCompleted != static_cast<bool>(bits & bit)) {
+        bits ^= bit;
+        isCompleted ? ++completed : --completed;
+    }
+}
+
+/**
+ * @brief Starts from to and copies the rows later changed since from. Blocks later still shares with from were
+ *        not written in between and are skipped whole
+ */
+PassengerTable PassengerTable::rebased(const PassengerTable &later, const PassengerTable &from,
+                                       const PassengerTable &to)
+{
+    PassengerTable table = to;
+    for (std::size_t index = 0; index < later.blocks.size(); ++index) {
+        const Block *laterBlock = later.blocks[index].get();
+        const Block *fromBlock = index < from.blocks.size() ? from.blocks[index].get() : nullptr;
+        if (!laterBlock || laterBlock == fromBlock) {
+            continue;
+        }
+
+        const std::size_t end = std::min(later.rowCount, (index + 1) * blockSize);
+        for (std::size_t id = std::max<std::size_t>(1, index * blockSize); id < end; ++id) {
+            const int passengerId = static_cast<int>(id);
+            if (!sameRow(later, from, passengerId)) {
+                table.assign(passengerId, later.stateOf(passengerId), later.isCompleted(passengerId),
+                             later.originOf(passengerId), later.destinationOf(passengerId), later.carOf(passengerId),
+                             later.requestTimeStepOf(passengerId), later.boardTimeStepOf(passengerId),
+                             later.exitTimeStepOf(passengerId));
+            }
+        }
+    }
+    return table;
+}
+
+void PassengerTable::writeCsv(std::ostream &out) const
+{
+    out << "passenger,state,completed,origin,destination,car,request,board,exit,wait,ride\n";
+    for (std::size_t id = 1; id < rowCount; ++id) {
+        const int passengerId = static_cast<int>(id);
+        const State state = stateOf(passengerId);
+        if (state == Absent) {
+            continue;
+        }
+
+        const int requestTimeStep = requestTimeStepOf(passengerId);
+        const int boardTimeStep = boardTimeStepOf(passengerId);
+        const int exitTimeStep = exitTimeStepOf(passengerId);
+        // Cars are numbered from 1 as in the log, the columns a passenger has not reached yet are left empty
+        const int car = carOf(passengerId);
+        out << passengerId << ',' << stateName(state) << ',' << isCompleted(passengerId) << ','
+            << originOf(passengerId) << ',' << destinationOf(passengerId) << ','
+            << (car >= 0 ? std::to_string(car + 1) : std::string()) << ','
+            << (requestTimeStep >= 0 ? std::to_string(requestTimeStep) : std::string()) << ','
+            << (boardTimeStep >= 0 ? std::to_string(boardTimeStep) : std::string()) << ','
+            << (exitTimeStep >= 0 ? std::to_string(exitTimeStep) : std::string()) << ','
+            << (boardTimeStep >= 0 ? std::to_string(boardTimeStep - requestTimeStep) : std::string()) << ','
+            << (exitTimeStep >= 0 ? std::to_string(exitTimeStep - boardTimeStep) : std::string()) << '\n';
+    }
+}
+
+bool PassengerTable::saveCsv(const std::string &path, std::string &error) const
+{
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::trunc);
+        if (out) {
+            writeCsv(out);
+        }
+        if (!out || !out.flush()) {
+            error = "cannot write " + temporaryPath;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+const char *PassengerTable::stateName(State state)
+{
+    switch (state) {
+    case Waiting: return "waiting";
+    case Riding: return "riding";
+    case Done: return "done";
+    default: return "absent";
+    }
+}
+
+bool PassengerTable::sameRow(const PassengerTable &a, const PassengerTable &b, int passengerId)
+{
+    return a.stateOf(passengerId) == b.stateOf(passengerId)
+        && a.isCompleted(passengerId) == b.isCompleted(passengerId)
+        && a.originOf(passengerId) == b.originOf(passengerId)
+        && a.destinationOf(passengerId) == b.destinationOf(passengerId)
+        && a.carOf(passengerId) == b.carOf(passengerId)
+        && a.requestTimeStepOf(passengerId) == b.requestTimeStepOf(passengerId)
+        && a.boardTimeStepOf(passengerId) == b.boardTimeStepOf(passengerId)
+        && a.exitTimeStepOf(passengerId) == b.exitTimeStepOf(passengerId);
+}
+
+const PassengerTable::Block *PassengerTable::blockOf(int passengerId) const
+{
+    if (passengerId < 1 || static_cast<std::size_t>(passengerId) >= rowCount) {
+        return nullptr;
+    }
+    return blocks[passengerId / blockSize].get();
+}
+
+PassengerTable::Block &PassengerTable::writableBlock(int passengerId)
+{
+    const std::size_t index = static_cast<std::size_t>(passengerId) / blockSize;
+    if (index >= blocks.size()) {
+        blocks.resize(index + 1);
+    }
+    rowCount = std::max(rowCount, static_cast<std::size_t>(passengerId) + 1);
+
+    std::shared_ptr<Block> &block = blocks[index];
+    if (!block) {
+        block = std::make_shared<Block>();
+    } else if (block.use_count() > 1) {
+        // Shared with a copy of the table, e.g. a checkpoint, copy it before writing
+        block = std::make_shared<Block>(*block);
+    }
+    return *block;
+}
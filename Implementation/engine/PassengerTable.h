@@ -0,0 +1,98 @@
+#ifndef PASSENGERTABLE_H
+#define PASSENGERTABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The PassengerTable class is the entity store of the passengers with an ID, indexed by passenger ID:
+ *        - The origin, destination and car of the passenger's latest journey
+ *        - Its state (waiting, riding, done) and the time steps of its request, boarding and exit
+ *        - A completion bit per passenger, set once the passenger reached a destination
+ *        Rows are stored as columns in blocks of blockSize passengers, a block is only allocated once a passenger
+ *        of it requests a car, so sparse IDs cost nothing and dense ones cost about 21 bytes per passenger.
+ *        Blocks are shared between copies and copied on write, a copy for a checkpoint costs one pointer per block
+ */
+class PassengerTable
+{
+public:
+    enum State : std::uint8_t {
+        Absent,     // No car request yet
+        Waiting,
+        Riding,
+        Done
+    };
+
+    static const int blockSize = 4096;
+
+    PassengerTable();
+
+    // Records a journey of the passenger, IDs below 1 are anonymous and not recorded
+    void request(int passengerId, int origin, int destination, int car, int timeStep);
+    void board(int passengerId, int timeStep);
+    void exit(int passengerId, int timeStep);
+
+    void clear();
+
+    // One past the highest passenger ID that requested a car
+    std::size_t size() const { return rowCount; }
+    // Passengers that reached a destination
+    std::size_t completedCount() const { return completed; }
+
+    State stateOf(int passengerId) const;
+    bool isCompleted(int passengerId) const;
+    int originOf(int passengerId) const;
+    int destinationOf(int passengerId) const;
+    int carOf(int passengerId) const;
+    int requestTimeStepOf(int passengerId) const;
+    int boardTimeStepOf(int passengerId) const;
+    int exitTimeStepOf(int passengerId) const;
+
+    // Writes a whole row, for the checkpoint file
+    void assign(int passengerId, State state, bool completed, int origin, int destination, int car,
+                int requestTimeStep, int boardTimeStep, int exitTimeStep);
+
+    // Table of a later point of a run, moved onto another run that matched it from the point from on: the rows
+    // written after from come from later, the others from to. Every write stamps the row with a later time step,
+    // so a row written after from always differs from its from version
+    static PassengerTable rebased(const PassengerTable &later, const PassengerTable &from, const PassengerTable &to);
+
+    // Writes "passenger,state,completed,origin,destination,car,request,board,exit,wait,ride" rows, one per
+    // passenger that requested a car
+    void writeCsv(std::ostream &out) const;
+    // Writes the CSV rows to a temporary file then renames it over path, so a reader never sees half a report
+    bool saveCsv(const std::string &path, std::string &error) const;
+
+    static const char *stateName(State state);
+
+private:
+    struct Block {
+        std::array<std::int16_t, blockSize> origin;
+        std::array<std::int16_t, blockSize> destination;
+        std::array<std::int32_t, blockSize> car;
+        std::array<std::uint8_t, blockSize> state;
+        std::array<std::int32_t, blockSize> requestTimeStep;
+        std::array<std::int32_t, blockSize> boardTimeStep;
+        std::array<std::int32_t, blockSize> exitTimeStep;
+        std::array<std::uint64_t, blockSize / 64> completedBits;
+
+        Block();
+    };
+
+    // Null if no passenger of the block requested a car
+    const Block *blockOf(int passengerId) const;
+    // The passenger's block, allocated or unshared first
+    Block &writableBlock(int passengerId);
+    static bool sameRow(const PassengerTable &a, const PassengerTable &b, int passengerId);
+
+    std::vector<std::shared_ptr<Block>> blocks;   // Null until a passenger of the block requests a car
+    std::size_t rowCount;
+    std::size_t completed;
+};
+
+#endif // PASSENGERTABLE_H
@@ -0,0 +1,207 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief One thread's ring, written by its thread only. written counts every event ever recorded, the event n is
+ *        in slot n % bufferCapacity until event n + bufferCapacity overwrites it. The slots are left uninitialized so
+ *        their pages are only touched as the ring fills
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(int threadIndex)
+        : threadIndex(threadIndex), events(new Profiler::Event[Profiler::bufferCapacity]) {}
+
+    int threadIndex;
+    bool leased = true;                         // Owned by a running thread, guarded by the registry mutex
+    std::unique_ptr<Profiler::Event[]> events;
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> clearedAt{0};    // Events before this one were dropped by clear()
+};
+
+// Every buffer, kept after its thread exits so its events can still be exported
+struct BufferRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+BufferRegistry &registry()
+{
+    static BufferRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief Hands a buffer to a thread on its first event, the only time recording takes a lock. The buffer of an
+ *        exited thread goes to the next new thread, so short lived workers (replications) do not add a ring each
+ */
+class BufferLease
+{
+public:
+    ~BufferLease() {
+        if (buffer) {
+            BufferRegistry &buffers = registry();
+            std::lock_guard<std::mutex> lock(buffers.mutex);
+            buffer->leased = false;
+        }
+    }
+
+    ThreadBuffer &get() {
+        if (!buffer) {
+            BufferRegistry &buffers = registry();
+            std::lock_guard<std::mutex> lock(buffers.mutex);
+            for (const std::shared_ptr<ThreadBuffer> &free : buffers.buffers) {
+                if (!free->leased) {
+                    free->leased = true;
+                    buffer = free.get();
+                    return *buffer;
+                }
+            }
+            buffers.buffers.push_back(std::make_shared<ThreadBuffer>(static_cast<int>(buffers.buffers.size()) + 1));
+            buffer = buffers.buffers.back().get();
+        }
+        return *buffer;
+    }
+
+private:
+    ThreadBuffer *buffer = nullptr;
+};
+
+ThreadBuffer &threadBuffer()
+{
+    thread_local BufferLease lease;
+    return lease.get();
+}
+
+struct ExportedEvent {
+    int threadIndex;
+    Profiler::Event event;
+};
+
+// Copies the events of a buffer that are still in its ring
+void collect(const ThreadBuffer &buffer, std::vector<ExportedEvent> &events)
+{
+    const std::uint64_t capacity = Profiler::bufferCapacity;
+    const std::uint64_t end = buffer.written.load(std::memory_order_acquire);
+    std::uint64_t begin = std::max(buffer.clearedAt.load(std::memory_order_relaxed),
+                                   end > capacity ? end - capacity : 0);
+
+    const std::size_t firstCopied = events.size();
+    for (std::uint64_t n = begin; n < end; ++n) {
+        events.push_back(ExportedEvent{buffer.threadIndex, buffer.events[n % capacity]});
+    }
+
+    // Slots the thread overwrote while they were copied hold newer events, drop them
+    const std::uint64_t writtenAfter = buffer.written.load(std::memory_order_acquire);
+    if (writtenAfter > begin + capacity) {
+        const std::uint64_t overwritten = std::min(writtenAfter - capacity - begin, end - begin);
+        events.erase(events.begin() + firstCopied, events.begin() + firstCopied + overwritten);
+    }
+}
+
+void writeJsonString(std::ostream &out, const char *text)
+{
+    out << '"';
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+}
+
+std::atomic<bool> Profiler::enabled(false);
+
+void Profiler::setEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+std::int64_t Profiler::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char *name, std::int64_t startNs, std::int64_t endNs)
+{
+    ThreadBuffer &buffer = threadBuffer();
+    const std::uint64_t n = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[n % bufferCapacity] = Event{name, startNs, endNs - startNs};
+    buffer.written.store(n + 1, std::memory_order_release);
+}
+
+void Profiler::clear()
+{
+    BufferRegistry &buffers = registry();
+    std::lock_guard<std::mutex> lock(buffers.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : buffers.buffers) {
+        buffer->clearedAt.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes complete ("X") events in microseconds, one trace thread per recording thread
+ */
+void Profiler::writeChromeTrace(std::ostream &out)
+{
+    std::vector<ExportedEvent> events;
+    std::vector<int> threadIndices;
+    {
+        BufferRegistry &buffers = registry();
+        std::lock_guard<std::mutex> lock(buffers.mutex);
+        for (const std::shared_ptr<ThreadBuffer> &buffer : buffers.buffers) {
+            collect(*buffer, events);
+            threadIndices.push_back(buffer->threadIndex);
+        }
+    }
+
+    std::int64_t originNs = 0;
+    if (!events.empty()) {
+        originNs = std::min_element(events.begin(), events.end(), [](const ExportedEvent &a, const ExportedEvent &b) {
+            return a.event.startNs < b.event.startNs;
+        })->event.startNs;
+    }
+
+    char number[32];
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    for (int threadIndex : threadIndices) {
+        out << (first ? "\n" : ",\n")
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << threadIndex
+            << ", \"args\": {\"name\": \"thread " << threadIndex << "\"}}";
+        first = false;
+    }
+    for (const ExportedEvent &exported : events) {
+        out << (first ? "\n" : ",\n") << "{\"name\": ";
+        writeJsonString(out, exported.event.name);
+        std::snprintf(number, sizeof(number), "%.3f", (exported.event.startNs - originNs) / 1000.0);
+        out << ", \"cat\": \"simulation\", \"ph\": \"X\", \"ts\": " << number;
+        std::snprintf(number, sizeof(number), "%.3f", exported.event.durationNs / 1000.0);
+        out << ", \"dur\": " << number << ", \"pid\": 1, \"tid\": " << exported.threadIndex << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
+
+bool Profiler::saveChromeTrace(const std::string &path, std::string &error)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (out) {
+        writeChromeTrace(out);
+    }
+    if (!out || !out.flush()) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef RANDOMSTREAM_H
+#define RANDOMSTREAM_H
+
+#include <bitset>
+#include <cstdint>
+
+/**
+ * @brief The RandomStream class is a counter-based random generator (SplitMix64):
+ *        - The n-th value is a pure function of the seed, the substream and n, so a stream has no hidden
+ *          state besides its position and can be repositioned with seek()
+ *        - Each substream of a seed has its own odd increment (gamma), so the substreams are independent
+ *        - Streams are plain values, every simulation owns its own and never shares them across threads
+ */
+class RandomStream
+{
+public:
+    RandomStream() : RandomStream(0, 0) {}
+
+    RandomStream(std::uint64_t seed, std::uint64_t substream)
+        : base(mix64(seed + goldenGamma * (2 * substream + 1))),
+          gamma(mixGamma(seed + goldenGamma * (2 * substream + 2))),
+          counter(0) {}
+
+    // Value at the current position, then advances by one
+    std::uint64_t next() { return mix64(base + gamma * ++counter); }
+
+    // Uniform in [0, bound), bound > 0
+    int nextInt(int bound) {
+        return static_cast<int>(((next() >> 32) * static_cast<std::uint64_t>(bound)) >> 32);
+    }
+
+    bool nextBool() { return (next() >> 63) != 0; }
+
+    // Number of values drawn so far, seek(position()) resumes exactly where the stream was
+    std::uint64_t position() const { return counter; }
+    void seek(std::uint64_t position) { counter = position; }
+
+    // SplitMix64 finalizer (Stafford's variant 13), a bijection that spreads every input bit over the output
+    static std::uint64_t mix64(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    static const std::uint64_t goldenGamma = 0x9E3779B97F4A7C15ULL;
+
+    // Odd increment with enough bit transitions to avoid weak Weyl sequences, as in SplittableRandom
+    static std::uint64_t mixGamma(std::uint64_t z) {
+        z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+        z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+        z = (z ^ (z >> 33)) | 1ULL;
+        return std::bitset<64>(z ^ (z >> 1)).count() < 24 ? z ^ 0xAAAAAAAAAAAAAAAAULL : z;
+    }
+
+    std::uint64_t base;
+    std::uint64_t gamma;
+    std::uint64_t counter;
+};
+
+#endif // RANDOMSTREAM_H
@@ -0,0 +1,180 @@
+#include "ReplicationRunner.h"
+#include "SimulationEngine.h"
+#include "RandomStream.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Substream the replication seeds are drawn from. The engine numbers its substreams from 0 (see
+// SimulationEngine::RandomSource), so the seeds are never correlated with a run of the base seed
+const std::uint64_t replicationSubstream = 0x5245504C49434154ULL; // "REPLICAT"
+
+// Two-sided 95% critical values of Student's t for 1 to 30 degrees of freedom
+const double tCritical95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+double criticalValue95(int degreesOfFreedom)
+{
+    const int tableSize = sizeof(tCritical95) / sizeof(tCritical95[0]);
+    return degreesOfFreedom <= tableSize ? tCritical95[degreesOfFreedom - 1] : 1.96;
+}
+
+}
+
+/**
+ * @brief Computes the mean, spread and 95% confidence interval of the mean of the samples
+ */
+SampleStatistics SampleStatistics::of(const std::vector<double> &samples)
+{
+    SampleStatistics statistics;
+    statistics.count = static_cast<int>(samples.size());
+    if (samples.empty()) {
+        return statistics;
+    }
+
+    double sum = 0.0;
+    statistics.minimum = samples.front();
+    statistics.maximum = samples.front();
+    for (double sample : samples) {
+        sum += sample;
+        statistics.minimum = std::min(statistics.minimum, sample);
+        statistics.maximum = std::max(statistics.maximum, sample);
+    }
+    statistics.mean = sum / statistics.count;
+
+    double squaredDeviations = 0.0;
+    for (double sample : samples) {
+        squaredDeviations += (sample - statistics.mean) * (sample - statistics.mean);
+    }
+
+    double halfWidth = 0.0;
+    if (statistics.count > 1) {
+        statistics.standardDeviation = std::sqrt(squaredDeviations / (statistics.count - 1));
+        halfWidth = criticalValue95(statistics.count - 1) * statistics.standardDeviation / std::sqrt(statistics.count);
+    }
+    statistics.confidenceLow = statistics.mean - halfWidth;
+    statistics.confidenceHigh = statistics.mean + halfWidth;
+    return statistics;
+}
+
+ReplicationRunner::ReplicationRunner(const SimulationConfig &config, int maxSteps)
+    : config(config),
+      maxSteps(maxSteps),
+      threadCount(0)
+{
+}
+
+void ReplicationRunner::setThreadCount(int threads)
+{
+    threadCount = std::max(0, threads);
+}
+
+int ReplicationRunner::getThreadCount() const
+{
+    if (threadCount > 0) {
+        return threadCount;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+/**
+ * @brief Runs the replications on the worker threads, the calling thread is one of them
+ * @param replications Number of replications
+ * @param baseSeed Seed the replication seeds are derived from
+ * @return The result of each replication, in replication order
+ */
+std::vector<ReplicationResult> ReplicationRunner::run(int replications, std::uint64_t baseSeed) const
+{
+    std::vector<ReplicationResult> results(std::max(0, replications));
+    std::atomic<int> nextReplication(0);
+
+    auto worker = [&]() {
+        for (int i = nextReplication++; i < replications; i = nextReplication++) {
+            results[i] = runReplication(replicationSeed(baseSeed, i));
+        }
+    };
+
+    const int workers = std::min(getThreadCount(), std::max(1, replications));
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    return results;
+}
+
+ReplicationResult ReplicationRunner::runReplication(std::uint64_t seed) const
+{
+    SimulationConfig replicationConfig = config;
+    replicationConfig.seed = seed;
+
+    // No log sink: every message is filtered out before it is formatted
+    SimulationEngine engine(replicationConfig);
+    engine.start();
+    engine.run(maxSteps);
+
+    ReplicationResult result;
+    result.seed = seed;
+    result.completed = !engine.isRunning();
+    result.completionTime = engine.getMetrics().timeSteps;
+    result.evacuationTime = engine.getMetrics().evacuationTime();
+    result.completedPassengers = engine.getCompletedPassengers();
+    result.deliveredPassengers = engine.getMetrics().journeysCompleted;
+    return result;
+}
+
+/**
+ * @brief Aggregates the outcome distributions, time based outcomes only count the completed replications
+ */
+ReplicationSummary ReplicationRunner::summarize(const std::vector<ReplicationResult> &results)
+{
+    std::vector<double> completionTimes;
+    std::vector<double> evacuationTimes;
+    std::vector<double> completedPassengers;
+    std::vector<double> deliveredPassengers;
+    completionTimes.reserve(results.size());
+    completedPassengers.reserve(results.size());
+    deliveredPassengers.reserve(results.size());
+
+    for (const ReplicationResult &result : results) {
+        if (result.completed) {
+            completionTimes.push_back(result.completionTime);
+            if (result.evacuationTime >= 0) {
+                evacuationTimes.push_back(result.evacuationTime);
+            }
+        }
+        completedPassengers.push_back(result.completedPassengers);
+        deliveredPassengers.push_back(result.deliveredPassengers);
+    }
+
+    ReplicationSummary summary;
+    summary.replications = static_cast<int>(results.size());
+    summary.completedRuns = static_cast<int>(completionTimes.size());
+    summary.evacuations = static_cast<int>(evacuationTimes.size());
+    summary.completionTime = SampleStatistics::of(completionTimes);
+    summary.evacuationTime = SampleStatistics::of(evacuationTimes);
+    summary.completedPassengers = SampleStatistics::of(completedPassengers);
+    summary.deliveredPassengers = SampleStatistics::of(deliveredPassengers);
+    return summary;
+}
+
+/**
+ * @brief The replication-th value of the base seed's replication substream
+ */
+std::uint64_t ReplicationRunner::replicationSeed(std::uint64_t baseSeed, int replication)
+{
+    RandomStream seeds(baseSeed, replicationSubstream);
+    seeds.seek(static_cast<std::uint64_t>(replication));
+    return seeds.next();
+}
@@ -0,0 +1,82 @@
+#ifndef REPLICATIONRUNNER_H
+#define REPLICATIONRUNNER_H
+
+#include "SimulationConfig.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The SampleStatistics struct describes the distribution of one outcome over the replications:
+ *        - Mean, standard deviation, minimum and maximum
+ *        - The 95% confidence interval of the mean (Student's t)
+ */
+struct SampleStatistics {
+    int count = 0;
+    double mean = 0.0;
+    double standardDeviation = 0.0;
+    double confidenceLow = 0.0;
+    double confidenceHigh = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+
+    static SampleStatistics of(const std::vector<double> &samples);
+};
+
+/**
+ * @brief The ReplicationResult struct holds the outcome of one replication
+ */
+struct ReplicationResult {
+    std::uint64_t seed = 0;
+    bool completed = false;        // False if the replication hit the time step limit
+    int completionTime = 0;        // Time steps processed
+    int evacuationTime = -1;       // Time steps from the first fire or power out alarm to the end, -1 without an alarm
+    int completedPassengers = 0;   // Includes the passengers completed by safety events
+    int deliveredPassengers = 0;   // Passengers a car took to their destination
+};
+
+/**
+ * @brief The ReplicationSummary struct aggregates the replications of a scenario
+ */
+struct ReplicationSummary {
+    int replications = 0;
+    int completedRuns = 0;
+    int evacuations = 0;
+    SampleStatistics completionTime;      // Over the completed replications
+    SampleStatistics evacuationTime;      // Over the completed replications with an evacuation
+    SampleStatistics completedPassengers;
+    SampleStatistics deliveredPassengers;
+};
+
+/**
+ * @brief The ReplicationRunner class is responsible for running independently seeded replications of one
+ *        scenario on every core (Monte Carlo batch mode):
+ *        - Each replication owns its SimulationEngine and its random generator, the action list is shared read-only
+ *        - Worker threads claim replications from an atomic counter, so no thread waits on another
+ *        - Results are stored by replication index, so the summary does not depend on the thread count
+ */
+class ReplicationRunner
+{
+public:
+    explicit ReplicationRunner(const SimulationConfig &config, int maxSteps = -1);
+
+    // Number of worker threads, 0 uses every hardware thread
+    void setThreadCount(int threads);
+    int getThreadCount() const;
+
+    // Runs the replications and returns their results in replication order
+    std::vector<ReplicationResult> run(int replications, std::uint64_t baseSeed) const;
+
+    static ReplicationSummary summarize(const std::vector<ReplicationResult> &results);
+
+    // Seed of a replication, well spread even for consecutive base seeds and replication indices
+    static std::uint64_t replicationSeed(std::uint64_t baseSeed, int replication);
+
+private:
+    ReplicationResult runReplication(std::uint64_t seed) const;
+
+    SimulationConfig config;
+    int maxSteps;
+    int threadCount;
+};
+
+#endif // REPLICATIONRUNNER_H
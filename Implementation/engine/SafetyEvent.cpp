@@ -0,0 +1,49 @@
+#include "SafetyEvent.h"
+
+namespace {
+
+struct KindInfo {
+    const char *name;
+    SafetyEvent::TargetType targetType;
+};
+
+const KindInfo kinds[SafetyEvent::KindCount] = {
+    {"help", SafetyEvent::CarTarget},
+    {"door-obstacle", SafetyEvent::CarTarget},
+    {"fire", SafetyEvent::FloorTarget},
+    {"overload", SafetyEvent::CarTarget},
+    {"power-out", SafetyEvent::NoTarget}
+};
+
+}
+
+const char *SafetyEvent::kindName(Kind kind)
+{
+    return kind < KindCount ? kinds[kind].name : "unknown";
+}
+
+bool SafetyEvent::kindFromName(std::string_view name, Kind &kind)
+{
+    for (int i = 0; i < KindCount; ++i) {
+        if (name == kinds[i].name) {
+            kind = static_cast<Kind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+SafetyEvent::TargetType SafetyEvent::targetType(Kind kind)
+{
+    return kind < KindCount ? kinds[kind].targetType : NoTarget;
+}
+
+std::vector<std::int32_t> SafetyEvent::timeSteps(const std::vector<SafetyEvent> &events)
+{
+    std::vector<std::int32_t> timeSteps;
+    timeSteps.reserve(events.size());
+    for (const SafetyEvent &event : events) {
+        timeSteps.push_back(event.timeStep);
+    }
+    return timeSteps;
+}
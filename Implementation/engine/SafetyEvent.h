@@ -0,0 +1,53 @@
+#ifndef SAFETYEVENT_H
+#define SAFETYEVENT_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The SafetyEvent struct is one scheduled occurrence of a safety alarm:
+ *          - Its kind, which selects the engine's handler through a table instead of comparing strings
+ *          - The time step it triggers at, a kind may occur any number of times
+ *          - An optional target, a floor or a car depending on the kind
+ */
+struct SafetyEvent {
+    enum Kind : std::uint8_t {
+        Help,
+        DoorObstacle,
+        Fire,
+        Overload,
+        PowerOut,
+        KindCount
+    };
+
+    // What the target of a kind is
+    enum TargetType {
+        NoTarget,      // The whole building
+        FloorTarget,
+        CarTarget
+    };
+
+    Kind kind;
+    std::int32_t timeStep;
+    std::int32_t target;       // Floor or car number, 0 if the event has no target
+
+    SafetyEvent() = default;
+    SafetyEvent(Kind k, int ts, int t = 0)
+        : kind(k), timeStep(ts), target(t) {}
+
+    // Name used by the scenario text, e.g. "door-obstacle"
+    static const char *kindName(Kind kind);
+
+    // Parses a name returned by kindName, returns false if the name is unknown
+    static bool kindFromName(std::string_view name, Kind &kind);
+
+    static TargetType targetType(Kind kind);
+
+    // Time steps of the events in list order, what the engine's safety calendar is built from
+    static std::vector<std::int32_t> timeSteps(const std::vector<SafetyEvent> &events);
+};
+
+static_assert(sizeof(SafetyEvent) <= 12, "SafetyEvent must stay a 12 byte record");
+
+#endif // SAFETYEVENT_H
@@ -0,0 +1,300 @@
+#include "ScenarioFile.h"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Bytes read from the input at a time, grown only for a line longer than a chunk
+const std::size_t chunkSize = 1 << 20;
+
+// Tokens of the longest directive, an action line
+const int maxTokens = 4;
+
+template <typename Integer>
+bool parseInteger(std::string_view token, Integer &value)
+{
+    const char *end = token.data() + token.size();
+    std::from_chars_result result = std::from_chars(token.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Parses one line at a time into the config and the action table
+class ScenarioParser
+{
+public:
+    ScenarioParser(SimulationConfig &config, ActionTable &actions)
+        : config(config), actions(actions), lineNumber(0), readSafetyEvent(false) {}
+
+    bool parseLine(const char *begin, const char *end) {
+        ++lineNumber;
+
+        std::string_view tokens[maxTokens];
+        int tokenCount = 0;
+        const char *position = begin;
+        while (position < end) {
+            while (position < end && (*position == ' ' || *position == '\t' || *position == '\r')) {
+                ++position;
+            }
+            if (position == end || *position == '#') {
+                break;
+            }
+
+            const char *tokenBegin = position;
+            while (position < end && *position != ' ' && *position != '\t' && *position != '\r') {
+                ++position;
+            }
+            if (tokenCount == maxTokens) {
+                return fail("too many values");
+            }
+            tokens[tokenCount++] = std::string_view(tokenBegin, position - tokenBegin);
+        }
+
+        return tokenCount == 0 || parseDirective(tokens, tokenCount);
+    }
+
+    const std::string &getError() const { return error; }
+
+private:
+    bool parseDirective(const std::string_view tokens[], int tokenCount) {
+        const std::string_view name = tokens[0];
+
+        // Action lines are by far the most frequent, try them first
+        PassengerAction::Type type;
+        if (PassengerAction::typeFromName(name, type)) {
+            int floor = 0;
+            int timeStep = 0;
+            int passengerId = 0;
+            if (tokenCount < 3 || tokenCount > 4 ||
+                !parseInteger(tokens[1], floor) || !parseInteger(tokens[2], timeStep) ||
+                (tokenCount == 4 && !parseInteger(tokens[3], passengerId))) {
+                return fail("expected " + std::string(name) + " FLOOR TIMESTEP [PASSENGERID]");
+            }
+            actions.append(PassengerAction(type, floor, timeStep, passengerId));
+            return true;
+        }
+
+        SafetyEvent::Kind kind;
+        if (SafetyEvent::kindFromName(name, kind)) {
+            return parseSafetyEvent(kind, tokens, tokenCount);
+        }
+
+        if (tokenCount != 2) {
+            return fail("expected " + std::string(name) + " VALUE");
+        }
+        const std::string_view value = tokens[1];
+
+        if (name == "passengers") {
+            return parseInteger(value, config.passengerCount) || fail("invalid passenger count");
+        }
+        if (name == "floors") {
+            return parseInteger(value, config.floorCount) || fail("invalid floor count");
+        }
+        if (name == "elevators") {
+            return parseInteger(value, config.elevatorCount) || fail("invalid elevator count");
+        }
+        if (name == "seed") {
+            return parseInteger(value, config.seed) || fail("invalid seed");
+        }
+        if (name == "floor-travel") {
+            return parseInteger(value, config.timing.floorTravelSteps) || fail("invalid floor travel time");
+        }
+        if (name == "acceleration") {
+            return parseInteger(value, config.timing.accelerationSteps) || fail("invalid acceleration time");
+        }
+        if (name == "door-dwell") {
+            return parseInteger(value, config.timing.doorDwellSteps) || fail("invalid door dwell time");
+        }
+        if (name == "safety-door-hold") {
+            return parseInteger(value, config.timing.safetyDoorHoldSteps) || fail("invalid safety door hold time");
+        }
+        if (name == "dispatcher") {
+            return Dispatcher::policyFromName(std::string(value), config.dispatchPolicy) ||
+                   fail("unknown dispatcher " + std::string(value));
+        }
+        return fail("unknown directive " + std::string(name));
+    }
+
+    // The first safety event line replaces the events config already had, later ones add to them
+    bool parseSafetyEvent(SafetyEvent::Kind kind, const std::string_view tokens[], int tokenCount) {
+        SafetyEvent event(kind, 0);
+        const bool targeted = SafetyEvent::targetType(kind) != SafetyEvent::NoTarget;
+        if (tokenCount < 2 || tokenCount > (targeted ? 3 : 2) || !parseInteger(tokens[1], event.timeStep) ||
+            (tokenCount == 3 && (!parseInteger(tokens[2], event.target) || event.target < 0))) {
+            return fail(std::string("expected ") + SafetyEvent::kindName(kind) + " TIMESTEP"
+                        + (targeted ? " [TARGET]" : ""));
+        }
+
+        if (!readSafetyEvent) {
+            config.safetyEvents.clear();
+            readSafetyEvent = true;
+        }
+        config.safetyEvents.push_back(event);
+        return true;
+    }
+
+    bool fail(const std::string &message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    }
+
+    SimulationConfig &config;
+    ActionTable &actions;
+    int lineNumber;
+    bool readSafetyEvent;
+    std::string error;
+};
+
+// Appends the decimal digits of value to the buffer
+template <typename Integer>
+void appendInteger(std::vector<char> &buffer, Integer value)
+{
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    buffer.insert(buffer.end(), digits, result.ptr);
+}
+
+void appendText(std::vector<char> &buffer, const char *text)
+{
+    buffer.insert(buffer.end(), text, text + std::strlen(text));
+}
+
+}
+
+/**
+ * @brief Reads the input chunk by chunk and parses every complete line in the chunk, a line cut at the end
+ *        of a chunk is moved to the front of the buffer and completed by the next read
+ */
+bool ScenarioFile::read(std::istream &in, SimulationConfig &config, std::string &error)
+{
+    SimulationConfig parsed = config;
+    ActionTable actions;
+    ScenarioParser parser(parsed, actions);
+
+    std::vector<char> buffer(chunkSize);
+    std::size_t pending = 0;
+    for (;;) {
+        if (pending == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        in.read(buffer.data() + pending, static_cast<std::streamsize>(buffer.size() - pending));
+        const std::size_t filled = pending + static_cast<std::size_t>(in.gcount());
+        const bool atEnd = !in;
+
+        const char *lineBegin = buffer.data();
+        const char *end = buffer.data() + filled;
+        while (const char *newline = static_cast<const char *>(std::memchr(lineBegin, '\n', end - lineBegin))) {
+            if (!parser.parseLine(lineBegin, newline)) {
+                error = parser.getError();
+                return false;
+            }
+            lineBegin = newline + 1;
+        }
+
+        if (atEnd) {
+            if (lineBegin < end && !parser.parseLine(lineBegin, end)) {
+                error = parser.getError();
+                return false;
+            }
+            break;
+        }
+
+        pending = static_cast<std::size_t>(end - lineBegin);
+        std::memmove(buffer.data(), lineBegin, pending);
+    }
+
+    if (in.bad()) {
+        error = "read error";
+        return false;
+    }
+
+    parsed.actions = std::make_shared<const ActionTable>(std::move(actions));
+    config = parsed;
+    return true;
+}
+
+/**
+ * @brief Formats the scenario into a buffer that is flushed to the output every chunk
+ */
+bool ScenarioFile::write(std::ostream &out, const SimulationConfig &config)
+{
+    std::vector<char> buffer;
+    buffer.reserve(chunkSize + 64);
+
+    auto flushBuffer = [&out, &buffer]() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    };
+    auto appendDirective = [&buffer](const char *name, auto value) {
+        appendText(buffer, name);
+        buffer.push_back(' ');
+        appendInteger(buffer, value);
+        buffer.push_back('\n');
+    };
+
+    appendText(buffer, "# Elevator simulation scenario\n");
+    appendDirective("passengers", config.passengerCount);
+    appendDirective("floors", config.floorCount);
+    appendDirective("elevators", config.elevatorCount);
+    appendText(buffer, "dispatcher ");
+    appendText(buffer, Dispatcher::policyName(config.dispatchPolicy));
+    buffer.push_back('\n');
+    appendDirective("seed", config.seed);
+    appendDirective("floor-travel", config.timing.floorTravelSteps);
+    appendDirective("acceleration", config.timing.accelerationSteps);
+    appendDirective("door-dwell", config.timing.doorDwellSteps);
+    appendDirective("safety-door-hold", config.timing.safetyDoorHoldSteps);
+
+    for (const SafetyEvent &event : config.safetyEvents) {
+        appendDirective(SafetyEvent::kindName(event.kind), event.timeStep);
+        if (event.target > 0) {
+            buffer.back() = ' ';
+            appendInteger(buffer, event.target);
+            buffer.push_back('\n');
+        }
+    }
+
+    const ActionTable &actions = *config.actions;
+    for (std::size_t i = 0; i < actions.size(); ++i) {
+        const PassengerAction action = actions.at(i);
+        appendText(buffer, PassengerAction::typeName(action.actionType));
+        buffer.push_back(' ');
+        appendInteger(buffer, action.floor);
+        buffer.push_back(' ');
+        appendInteger(buffer, action.timeStep);
+        buffer.push_back(' ');
+        appendInteger(buffer, action.passengerId);
+        buffer.push_back('\n');
+
+        if (buffer.size() >= chunkSize) {
+            flushBuffer();
+        }
+    }
+    flushBuffer();
+
+    return static_cast<bool>(out);
+}
+
+bool ScenarioFile::load(const std::string &path, SimulationConfig &config, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return read(in, config, error);
+}
+
+bool ScenarioFile::save(const std::string &path, const SimulationConfig &config, std::string &error)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !write(out, config)) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef SCENARIOFILE_H
+#define SCENARIOFILE_H
+
+#include "SimulationConfig.h"
+#include <iosfwd>
+#include <string>
+
+/**
+ * @brief The ScenarioFile class reads and writes complete scenarios as text, one directive per line:
+ *            passengers 3
+ *            floors 10
+ *            elevators 2
+ *            dispatcher collective
+ *            seed 42
+ *            floor-travel 2          Car timing in time steps: per floor, acceleration, door dwell at a stop and
+ *            acceleration 1          doors held open by a safety event
+ *            door-dwell 5
+ *            safety-door-hold 10
+ *            fire 30 5               Safety event: help, door-obstacle, fire, overload or power-out, its time step
+ *                                    and optional target (a car, the floor of a fire), may be repeated
+ *            RequestCar 5 0 1        Passenger action: type, floor, time step and optional passenger id
+ *        Blank lines and lines starting with # are ignored.
+ *        The reader streams the input in fixed size chunks and parses each line in place, actions are appended
+ *        straight into one ActionTable, so a file of millions of actions loads without a copy per line
+ */
+class ScenarioFile
+{
+public:
+    // Parses the scenario into config, whose action list is replaced. Directives missing from the input keep
+    // the value config already had. Returns false and sets error to "line N: ..." at the first invalid line
+    static bool read(std::istream &in, SimulationConfig &config, std::string &error);
+
+    // Writes every directive of config, the actions in the order of the action list
+    static bool write(std::ostream &out, const SimulationConfig &config);
+
+    static bool load(const std::string &path, SimulationConfig &config, std::string &error);
+    static bool save(const std::string &path, const SimulationConfig &config, std::string &error);
+};
+
+#endif // SCENARIOFILE_H
@@ -0,0 +1,63 @@
+#include "SimulationConfig.h"
+
+bool SimulationConfig::validate(std::string &error) const
+{
+    if (passengerCount < 1 || passengerCount > maxPassengerCount) {
+        error = "the passenger count must be between 1 and " + std::to_string(maxPassengerCount);
+        return false;
+    }
+    if (floorCount < 1 || floorCount > maxFloorCount) {
+        error = "the floor count must be between 1 and " + std::to_string(maxFloorCount);
+        return false;
+    }
+    if (elevatorCount < 1 || elevatorCount > maxElevatorCount) {
+        error = "the elevator count must be between 1 and " + std::to_string(maxElevatorCount);
+        return false;
+    }
+    if (dispatchPolicy < 0 || dispatchPolicy >= Dispatcher::PolicyCount) {
+        error = "unknown dispatch policy";
+        return false;
+    }
+    if (timing.floorTravelSteps < 1 || timing.doorDwellSteps < 1) {
+        error = "floor travel and door dwell must take at least 1 time step";
+        return false;
+    }
+    if (timing.accelerationSteps < 0 || timing.safetyDoorHoldSteps < 0) {
+        error = "acceleration and safety door hold times must not be negative";
+        return false;
+    }
+    if (!actions) {
+        error = "missing action list";
+        return false;
+    }
+
+    for (const SafetyEvent &event : safetyEvents) {
+        if (event.kind >= SafetyEvent::KindCount) {
+            error = "unknown safety event";
+            return false;
+        }
+        const std::string name = SafetyEvent::kindName(event.kind);
+        if (event.timeStep < 0) {
+            error = name + " event at negative time step " + std::to_string(event.timeStep);
+            return false;
+        }
+
+        int targetCount = 0;
+        switch (SafetyEvent::targetType(event.kind)) {
+        case SafetyEvent::CarTarget:
+            targetCount = elevatorCount;
+            break;
+        case SafetyEvent::FloorTarget:
+            targetCount = floorCount;
+            break;
+        case SafetyEvent::NoTarget:
+            break;
+        }
+        if (event.target < 0 || event.target > targetCount) {
+            error = name + " event at time step " + std::to_string(event.timeStep) + " targets "
+                  + std::to_string(event.target) + ", outside the building";
+            return false;
+        }
+    }
+    return true;
+}
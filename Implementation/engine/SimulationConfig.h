@@ -0,0 +1,62 @@
+#ifndef SIMULATIONCONFIG_H
+#define SIMULATIONCONFIG_H
+
+#include "ActionTable.h"
+#include "Dispatcher.h"
+#include "MappedScenario.h"
+#include "SafetyEvent.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The CarTiming struct holds how many time steps (seconds) the cars take, the defaults are one floor per
+ *        time step and one time step per stop
+ */
+struct CarTiming {
+    int floorTravelSteps = 1;       // Per floor at full speed
+    int accelerationSteps = 0;      // Added to the first floor after a stop and to the last floor before one
+    int doorDwellSteps = 1;         // Doors open at a stop, passengers exit and board
+    int safetyDoorHoldSteps = 10;   // Doors held open by a safety event before the bell rings and they close
+};
+
+/**
+ * @brief The SimulationConfig struct is the plain description of a scenario handed to the SimulationEngine:
+ *        - The building setup (passengers, floors, elevators), the dispatch policy of the elevator bank and the
+ *          travel, acceleration and door times of its cars
+ *        - The safety events, any number of each kind, those of one time step trigger in list order
+ *        - The passengers' scheduled actions, shared with the setup that published them
+ *        - Optionally a memory-mapped binary scenario whose time-sorted actions are streamed during the run
+ *        - The seed of the random passengers and safety event outcomes, the same seed replays the same run
+ *        Front ends build it once from their inputs and validate it before the run, the engine only reads it
+ */
+struct SimulationConfig {
+    int passengerCount = 0;
+    int floorCount = 0;
+    int elevatorCount = 0;
+    Dispatcher::Policy dispatchPolicy = Dispatcher::Collective;
+    CarTiming timing;
+
+    std::vector<SafetyEvent> safetyEvents;
+
+    std::uint64_t seed = 0;
+
+    PassengerActionSnapshot actions = std::make_shared<const ActionTable>();
+
+    // Read in time order on top of actions, only the records of the current time step are held in memory
+    std::shared_ptr<const MappedScenario> actionStream;
+
+    // Checks the building against the limits below, the dispatch policy, the car timing and the safety events. Returns false
+    // and sets error to the first problem found. Action floors are not checked, the engine clamps them to the building
+    bool validate(std::string &error) const;
+
+    // Binary scenarios store floors in 16 bits
+    static const int maxFloorCount = 32767;
+    // Every car keeps two passenger lists per floor, and each dispatch weighs every car
+    static const int maxElevatorCount = 256;
+    // Every random passenger takes a row of the passenger table (about 21 bytes) and is numbered after the
+    // scenario's passenger IDs
+    static const int maxPassengerCount = 10000000;
+};
+
+#endif // SIMULATIONCONFIG_H
@@ -0,0 +1,973 @@
+#include "SimulationEngine.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+// Formats and emits message only when its category and level are enabled
+#define ENGINE_LOG(category, level, message) \
+    ENGINE_LOG_ABOUT(category, level, SimulationLog::Subject(), message)
+// Same, for a message about the car and the passenger of subject
+#define ENGINE_LOG_ABOUT(category, level, subject, message) \
+    SIM_LOG_IF(logFilter, SimulationLog::category, SimulationLog::level, logSink, subject, message)
+
+namespace {
+
+// Streamed records read between two page releases (1 MiB)
+const std::uint64_t streamReleaseRecords = 65536;
+
+std::string elevatorStatus(const ElevatorCar &car)
+{
+    return "Elevator " + std::to_string(car.id) + " is at floor " + std::to_string(car.floor)
+         + ", state: " + ElevatorCar::stateName(car.state) + ".";
+}
+
+std::string floorAtTime(const PassengerAction &action)
+{
+    return std::to_string(action.floor) + " at time step " + std::to_string(action.timeStep) + ".";
+}
+
+std::string completedStatus(int completedPassengers, int totalPassengers)
+{
+    return "Completed passengers: " + std::to_string(completedPassengers) + "/" + std::to_string(totalPassengers);
+}
+
+// The car an event targets, none for a floor or the whole building
+SimulationLog::Subject eventSubject(const SafetyEvent &event)
+{
+    if (event.target > 0 && SafetyEvent::targetType(event.kind) == SafetyEvent::CarTarget) {
+        return SimulationLog::car(event.target);
+    }
+    return SimulationLog::Subject();
+}
+
+// " (elevator 2)" or " (floor 5)" for an event with a target, empty for the whole building
+std::string eventTarget(const SafetyEvent &event)
+{
+    if (event.target <= 0) {
+        return std::string();
+    }
+    switch (SafetyEvent::targetType(event.kind)) {
+    case SafetyEvent::CarTarget:
+        return " (elevator " + std::to_string(event.target) + ")";
+    case SafetyEvent::FloorTarget:
+        return " (floor " + std::to_string(event.target) + ")";
+    case SafetyEvent::NoTarget:
+        break;
+    }
+    return std::string();
+}
+
+std::string oneDecimal(double value)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f", value);
+    return text;
+}
+
+}
+
+// Indexed by SafetyEvent::Kind
+const SimulationEngine::SafetyHandler SimulationEngine::safetyHandlers[SafetyEvent::KindCount] = {
+    &SimulationEngine::handleHelp,
+    &SimulationEngine::handleDoorObstacle,
+    &SimulationEngine::handleFire,
+    &SimulationEngine::handleOverload,
+    &SimulationEngine::handlePowerOut
+};
+
+SimulationEngine::SimulationEngine(const SimulationConfig &config, LogSink logSink)
+    : config(config),
+      logSink(logSink),
+      logFilter(logSink ? LogFilter() : LogFilter(SimulationLog::Disabled)),
+      checkpointInterval(0)
+{
+    if (!this->config.actions) {
+        this->config.actions = std::make_shared<const ActionTable>();
+    }
+}
+
+int SimulationEngine::firstRandomPassengerIdOf(const SimulationConfig &config)
+{
+    int highestId = std::max(0, config.passengerCount);
+    if (config.actions) {
+        for (std::int32_t passengerId : config.actions->getPassengerIds()) {
+            highestId = std::max(highestId, static_cast<int>(passengerId));
+        }
+    }
+    if (config.actionStream) {
+        highestId = std::max(highestId, static_cast<int>(config.actionStream->header().highestPassengerId));
+    }
+    return highestId + 1;
+}
+
+/**
+ * @brief Sets which categories and levels are formatted, a missing log sink keeps every category disabled
+ */
+void SimulationEngine::setLogFilter(const LogFilter &filter)
+{
+    logFilter = logSink ? filter : LogFilter(SimulationLog::Disabled);
+}
+
+/**
+ * @brief Resets the run state, every car starts idle at floor 1
+ */
+void SimulationEngine::start()
+{
+    state.simulationRunning = true;
+    state.currentTimeStep = 0;
+    state.completedPassengers = 0;
+    state.randomPassengerBase = firstRandomPassengerIdOf(config) - 1;
+    state.randomStreams.clear();
+    for (int i = 0; i < RandomSourceCount; ++i) {
+        state.randomStreams.emplace_back(config.seed, i);
+    }
+    state.calendar.build(*config.actions);
+    const std::vector<std::int32_t> safetyTimeSteps = SafetyEvent::timeSteps(config.safetyEvents);
+    state.safetyCalendar.build(safetyTimeSteps, safetyTimeSteps.size());
+    state.streamCursor = 0;
+    state.streamReleased = 0;
+
+    dispatcher = Dispatcher::create(config.dispatchPolicy);
+    const int carCount = std::max(1, config.elevatorCount);
+    const int floorCount = std::max(1, config.floorCount);
+    state.cars.clear();
+    state.cars.reserve(carCount);
+    for (int i = 0; i < carCount; ++i) {
+        state.cars.emplace_back(i + 1, floorCount);
+    }
+
+    state.journeys.clear();
+    state.freeJourneySlots.clear();
+    state.passengers.clear();
+    state.safetyDoorsClosing.clear();
+    state.metrics = SimulationMetrics();
+
+    state.exitActions.clear();
+    state.exitActions.add(*config.actions, 0);
+    state.exitActionPaired.assign(config.actions->size(), false);
+
+    checkpoints.clear();
+}
+
+/**
+ * @brief Processes the current time step and advances the simulation time to the next time step something
+ *        happens at, the time steps in between change nothing
+ * @return True while the simulation is still running
+ */
+bool SimulationEngine::step()
+{
+    if (!state.simulationRunning) {
+        return false;
+    }
+
+    processEventTimeStep(INT_MAX);
+    return state.simulationRunning;
+}
+
+/**
+ * @brief Runs the simulation to completion without any wall-clock delay, jumping from event to event
+ * @param maxSteps Upper bound on the simulated time steps, -1 for no limit
+ * @return Number of time steps simulated
+ */
+int SimulationEngine::run(int maxSteps)
+{
+    const int firstTimeStep = state.currentTimeStep;
+    const int limit = maxSteps < 0 || maxSteps > INT_MAX - firstTimeStep ? INT_MAX : firstTimeStep + maxSteps;
+    while (state.simulationRunning && state.currentTimeStep < limit) {
+        processEventTimeStep(limit);
+    }
+    return state.currentTimeStep - firstTimeStep;
+}
+
+/**
+ * @brief Processes the current time step if something happens at it, then moves to the next event, at most to limit
+ */
+void SimulationEngine::processEventTimeStep(int limit)
+{
+    if (checkpointInterval > 0 && state.currentTimeStep % checkpointInterval == 0) {
+        takeCheckpoint();
+    }
+
+    // A run that stopped at its limit resumes at a time step that may have nothing to process
+    if (firstEventTimeStep(state.currentTimeStep) == state.currentTimeStep || isComplete()) {
+        processSimulationStep();
+        if (!state.simulationRunning) {
+            ++state.currentTimeStep;
+            return;
+        }
+    }
+    advanceTo(std::min(firstEventTimeStep(state.currentTimeStep + 1), limit));
+}
+
+/**
+ * @brief Earliest time step from timeStep on with something to process: a due action, streamed record, safety
+ *        event or closing door, a car reaching its next stop or closing its doors, or the next random passenger
+ *        (one per time step until every passenger requested a car). INT_MAX if nothing is pending
+ */
+int SimulationEngine::firstEventTimeStep(int timeStep) const
+{
+    if (state.metrics.journeysRequested < config.passengerCount) {
+        return timeStep;
+    }
+
+    int next = INT_MAX;
+    auto consider = [&next, timeStep](int eventTimeStep) {
+        next = std::min(next, std::max(eventTimeStep, timeStep));
+    };
+    if (!state.calendar.isEmpty()) {
+        consider(state.calendar.nextTimeStep());
+    }
+    if (!state.safetyCalendar.isEmpty()) {
+        consider(state.safetyCalendar.nextTimeStep());
+    }
+    if (config.actionStream && state.streamCursor < config.actionStream->size()) {
+        consider(config.actionStream->at(state.streamCursor).timeStep);
+    }
+    if (!state.safetyDoorsClosing.empty()) {
+        consider(state.safetyDoorsClosing.front());
+    }
+    for (const ElevatorCar &car : state.cars) {
+        // An idle car without stops waits for a call
+        if (!car.stops.empty() || car.state != ElevatorCar::Idle) {
+            consider(car.readyTimeStep);
+        }
+    }
+    return next;
+}
+
+/**
+ * @brief Skips the time steps before timeStep, keeping the checkpoints due in between.
+ *        Nothing happens at a skipped time step, so its checkpoint is the current state at that time step
+ */
+void SimulationEngine::advanceTo(int timeStep)
+{
+    if (timeStep == INT_MAX) {
+        // Nothing is pending, time passes one step at a time
+        timeStep = state.currentTimeStep + 1;
+    }
+    while (checkpointInterval > 0) {
+        const int interval = checkpointInterval;
+        const int checkpointTimeStep = (state.currentTimeStep / interval + 1) * interval;
+        if (checkpointTimeStep >= timeStep) {
+            break;
+        }
+        state.currentTimeStep = checkpointTimeStep;
+        state.metrics.timeSteps = checkpointTimeStep;
+        takeCheckpoint();
+    }
+    state.currentTimeStep = timeStep;
+    state.metrics.timeSteps = timeStep;
+}
+
+/**
+ * @brief Schedules the actions appended since the current snapshot without copying the list
+ * @param snapshot The newest published action list
+ */
+void SimulationEngine::updateActions(const PassengerActionSnapshot &snapshot)
+{
+    if (!snapshot || snapshot == config.actions) {
+        return;
+    }
+
+    config.actions = snapshot;
+    const std::size_t firstNewIndex = state.knownActionCount();
+    scheduleUnknownActions();
+
+    // Random passengers from now on are numbered after a new passenger ID past theirs, the ones already
+    // numbered keep their IDs
+    if (!state.randomStreams.empty()) {
+        const int numbered = static_cast<int>(state.randomStreams[RandomPassengerOrigin].position());
+        const std::vector<std::int32_t> &passengerIds = config.actions->getPassengerIds();
+        for (std::size_t i = firstNewIndex; i < passengerIds.size(); ++i) {
+            state.randomPassengerBase = std::max(state.randomPassengerBase, passengerIds[i] - numbered);
+        }
+    }
+
+    // The checkpoints ahead of the current time step were taken without the new actions
+    checkpoints.erase(checkpoints.upper_bound(state.currentTimeStep), checkpoints.end());
+}
+
+/**
+ * @brief Schedules and indexes the actions of config.actions the state does not know yet
+ */
+void SimulationEngine::scheduleUnknownActions()
+{
+    const std::size_t firstNewIndex = state.knownActionCount();
+    for (std::size_t i = firstNewIndex; i < config.actions->size(); ++i) {
+        state.calendar.schedule(config.actions->timeStepAt(i), static_cast<int>(i));
+    }
+
+    state.exitActionPaired.resize(config.actions->size(), false);
+    state.exitActions.add(*config.actions, firstNewIndex);
+}
+
+/**
+ * @brief Checks that the state was saved by an engine with this configuration, then continues from it
+ * @param savedState A state from getState(), getCheckpoints() or a checkpoint file
+ * @return False if the elevator bank, the random substreams or the action positions do not fit the configuration
+ */
+bool SimulationEngine::restoreState(const SimulationState &savedState)
+{
+    if (!fitsConfig(savedState)) {
+        return false;
+    }
+
+    if (!dispatcher) {
+        dispatcher = Dispatcher::create(config.dispatchPolicy);
+    }
+    state = savedState;
+    scheduleUnknownActions();
+
+    // Pages released by the saving engine are read again from the file when needed
+    return true;
+}
+
+/**
+ * @brief Continues from a state of a run with an earlier version of the action list. The calendar moves the
+ *        edited actions to their new time step, which hands out the same actions as a calendar built from the
+ *        current list as long as every edited action is due at or after the state's time step
+ * @param savedState A state of the earlier run
+ * @param editedExitPassengers Passengers whose ExitCar actions were edited, their exits are indexed again
+ * @return False if the state does not fit the configuration
+ */
+bool SimulationEngine::restoreEditedState(const SimulationState &savedState, const std::vector<int> &editedExitPassengers)
+{
+    if (!fitsConfig(savedState)) {
+        return false;
+    }
+
+    if (!dispatcher) {
+        dispatcher = Dispatcher::create(config.dispatchPolicy);
+    }
+    state = savedState;
+    state.calendar.refresh(*config.actions);
+    state.reindexExits(*config.actions, editedExitPassengers);
+    scheduleUnknownActions();
+    return true;
+}
+
+bool SimulationEngine::fitsConfig(const SimulationState &savedState) const
+{
+    const std::size_t carCount = static_cast<std::size_t>(std::max(1, config.elevatorCount));
+    const std::size_t floorSlots = static_cast<std::size_t>(std::max(1, config.floorCount)) + 1;
+    const std::uint64_t streamSize = config.actionStream ? config.actionStream->size() : 0;
+
+    if (savedState.randomStreams.size() != RandomSourceCount || savedState.cars.size() != carCount ||
+        savedState.knownActionCount() > config.actions->size() ||
+        savedState.calendar.getBuiltCount() > savedState.knownActionCount() ||
+        savedState.safetyCalendar.getBuiltCount() != config.safetyEvents.size() ||
+        savedState.streamCursor > streamSize || savedState.streamReleased > savedState.streamCursor) {
+        return false;
+    }
+    for (const ElevatorCar &car : savedState.cars) {
+        if (car.waitingByFloor.size() != floorSlots || car.ridingByFloor.size() != floorSlots) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Starts keeping checkpoints, the next one is taken at the next time step that is a multiple of steps
+ */
+void SimulationEngine::setCheckpointInterval(int steps)
+{
+    checkpointInterval = std::max(0, steps);
+    if (checkpointInterval == 0) {
+        checkpoints.clear();
+    }
+}
+
+/**
+ * @brief Copies the state before the current time step is processed, thinning the checkpoints out to maxCheckpoints
+ */
+void SimulationEngine::takeCheckpoint()
+{
+    checkpoints.emplace(state.currentTimeStep, state);
+
+    while (static_cast<int>(checkpoints.size()) > maxCheckpoints) {
+        checkpointInterval *= 2;
+        for (auto checkpoint = checkpoints.begin(); checkpoint != checkpoints.end();) {
+            checkpoint = checkpoint->first % checkpointInterval != 0 ? checkpoints.erase(checkpoint) : std::next(checkpoint);
+        }
+    }
+}
+
+/**
+ * @brief Jumps to a time step, re-simulating at most one checkpoint interval when checkpoints are kept
+ * @param timeStep The time step to process next
+ * @return True if the simulation is at timeStep
+ */
+bool SimulationEngine::seek(int timeStep)
+{
+    auto checkpoint = checkpoints.upper_bound(timeStep);
+    if (checkpoint != checkpoints.begin()) {
+        --checkpoint;
+        if (timeStep < state.currentTimeStep || checkpoint->first > state.currentTimeStep) {
+            state = checkpoint->second;
+        }
+    }
+    if (timeStep < state.currentTimeStep) {
+        // No checkpoint before timeStep, replay from the beginning
+        start();
+    }
+
+    // The time steps in between were already shown, replay them silently
+    const LogFilter visibleFilter = logFilter;
+    logFilter = LogFilter(SimulationLog::Disabled);
+    run(timeStep - state.currentTimeStep);
+    logFilter = visibleFilter;
+
+    return state.currentTimeStep == timeStep;
+}
+
+/**
+ * @brief Every passenger is completed. Doors still held open by a safety event do not keep the run going: the
+ *        cars would go on delivering passengers an evacuation already completed
+ */
+bool SimulationEngine::isComplete() const
+{
+    return state.completedPassengers >= config.passengerCount;
+}
+
+/**
+ * @brief Completes count more passengers, never past the passenger count, so a passenger completed by a safety
+ *        event is not counted again when a car delivers it
+ */
+void SimulationEngine::completePassengers(int count)
+{
+    state.completedPassengers = std::min(config.passengerCount, state.completedPassengers + count);
+}
+
+void SimulationEngine::logSimulationComplete()
+{
+    ENGINE_LOG(Lifecycle, Info, "----------------");
+    ENGINE_LOG(Lifecycle, Info, "All passengers have reached their destinations.");
+    ENGINE_LOG(Lifecycle, Info, "Simulation Complete");
+    ENGINE_LOG(Lifecycle, Info, std::string("Dispatch policy: ") + Dispatcher::policyName(config.dispatchPolicy)
+                                + ", elevators: " + std::to_string(state.cars.size()));
+    ENGINE_LOG(Lifecycle, Info, "Throughput: " + oneDecimal(state.metrics.throughputPerMinute()) + " passengers/min"
+                                + ", average wait: " + oneDecimal(state.metrics.averageWait()) + " s"
+                                + ", average ride: " + oneDecimal(state.metrics.averageRide()) + " s");
+    state.simulationRunning = false;
+}
+
+/**
+ * @brief Processes the passengers' actions, the elevator bank and the safety events of the current time step
+ */
+void SimulationEngine::processSimulationStep()
+{
+    PROFILE_SCOPE("SimulationEngine::processSimulationStep");
+
+    // Check if all passengers have reached their destinations
+    if (isComplete()) {
+        logSimulationComplete();
+        return;
+    }
+
+    ENGINE_LOG(Lifecycle, Info, "----------------");
+
+    // Process actions that should happen at this time step, requests first so an
+    // ExitCar of the same time step can still give them their destination
+    {
+        PROFILE_SCOPE("SimulationEngine::takeDueActions");
+        dueActions.clear();
+        state.calendar.takeDue(state.currentTimeStep, dueActions);
+        takeDueRecords();
+    }
+    for (bool exits : {false, true}) {
+        for (int index : dueActions) {
+            if ((config.actions->typeAt(index) == PassengerAction::ExitCar) == exits) {
+                executePassengerAction(index);
+            }
+        }
+        for (const ScenarioRecord &record : dueRecords) {
+            if ((record.type == PassengerAction::ExitCar) == exits) {
+                executePassengerAction(record.action(), record.flags & ScenarioRecord::Matched, record.matchedFloor);
+            }
+        }
+    }
+
+    // If no scheduled actions, generate random behavior
+    if (dueActions.empty() && dueRecords.empty()) {
+        randomizePassengerBehaviour();
+    }
+
+    moveCars();
+
+    // Check for safety events at this time step
+    processSafetyEvents();
+
+    state.metrics.timeSteps = state.currentTimeStep + 1;
+
+    // Check again if all passengers have been completed after this step
+    if (isComplete()) {
+        logSimulationComplete();
+    }
+}
+
+/**
+ * @brief Pairs a scheduled action with the rest of the action list, then executes it
+ * @param actionIndex Index of the due action
+ */
+void SimulationEngine::executePassengerAction(int actionIndex)
+{
+    const PassengerAction action = config.actions->at(actionIndex);
+
+    if (action.actionType == PassengerAction::RequestCar) {
+        int exitFloor = takePairedExitFloor(action);
+        executePassengerAction(action, exitFloor >= 0, exitFloor);
+    } else {
+        executePassengerAction(action, state.exitActionPaired[actionIndex], action.floor);
+    }
+}
+
+/**
+ * @brief Manages passengers' behaviours, car requests become journeys handed to the dispatcher
+ * @param action The due action
+ * @param matched True if the action was paired: a RequestCar with its ExitCar, or an ExitCar with its RequestCar
+ * @param matchedFloor Destination of a matched RequestCar
+ */
+void SimulationEngine::executePassengerAction(const PassengerAction &action, bool matched, int matchedFloor)
+{
+    PROFILE_SCOPE("SimulationEngine::executePassengerAction");
+
+    switch (action.actionType) {
+    case PassengerAction::RequestCar: {
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(action.passengerId),
+                         "> Passenger " + std::to_string(action.passengerId) + " requested car at floor "
+                         + floorAtTime(action));
+
+        const int origin = clampFloor(action.floor);
+        int destination = matchedFloor;
+        if (!matched) {
+            // No exit scheduled for this passenger, pick a random destination like a random passenger
+            destination = origin;
+            while (config.floorCount > 1 && destination == origin) {
+                destination = randomInt(RandomPassengerDestination, config.floorCount) + 1;
+            }
+        }
+        requestJourney(action.passengerId, origin, clampFloor(destination));
+        break;
+    }
+    case PassengerAction::ExitCar:
+        // Paired exits became the destination of their car request, the car drops the passenger off when it arrives
+        if (!matched) {
+            ENGINE_LOG_ABOUT(Passenger, Warning, SimulationLog::passenger(action.passengerId),
+                             "> Passenger " + std::to_string(action.passengerId)
+                             + " has no car request for the exit at floor " + floorAtTime(action));
+        }
+        break;
+    case PassengerAction::OpenDoor:
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(action.passengerId),
+                         "> Door opened at floor " + floorAtTime(action));
+        break;
+    case PassengerAction::CloseDoor:
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(action.passengerId),
+                         "> Door closed at floor " + floorAtTime(action));
+        break;
+    case PassengerAction::PushHelp:
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(action.passengerId),
+                         "> Help button pushed at floor " + floorAtTime(action));
+        // Handle it like a scheduled help alarm
+        triggerSafetyEvent(SafetyEvent(SafetyEvent::Help, state.currentTimeStep));
+        break;
+    }
+}
+
+/**
+ * @brief Reads the binary scenario's records of the current time step, records are sorted by time step so the
+ *        cursor only moves forward. Records scheduled before time step 0 are skipped like the calendar does
+ */
+void SimulationEngine::takeDueRecords()
+{
+    dueRecords.clear();
+    if (!config.actionStream) {
+        return;
+    }
+
+    const MappedScenario &stream = *config.actionStream;
+    while (state.streamCursor < stream.size() && stream.at(state.streamCursor).timeStep <= state.currentTimeStep) {
+        const ScenarioRecord &record = stream.at(state.streamCursor);
+        if (record.timeStep == state.currentTimeStep) {
+            dueRecords.push_back(record);
+        }
+        ++state.streamCursor;
+    }
+
+    // Hand the simulated part of the trace back, so resident memory does not grow with the trace length
+    if (state.streamCursor - state.streamReleased >= streamReleaseRecords) {
+        stream.release(state.streamReleased, state.streamCursor);
+        state.streamReleased = state.streamCursor;
+    }
+}
+
+/**
+ * @brief Randomizes passengers' behaviour, a passenger requests a car at a random floor to a different random floor
+ */
+void SimulationEngine::randomizePassengerBehaviour()
+{
+    int remainingPassengers = config.passengerCount - state.metrics.journeysRequested;
+    if (remainingPassengers <= 0) return;
+
+    // Every random passenger draws one origin, so the origin stream's position numbers them
+    const int passengerId = state.randomPassengerBase + 1
+        + static_cast<int>(state.randomStreams[RandomPassengerOrigin].position());
+
+    // Generate random entry floor and have passenger exit on random exit floor
+    int randomFloor = randomInt(RandomPassengerOrigin, config.floorCount) + 1;
+
+    // Randomly select a different floor for the passenger to exit at
+    int exitFloor = randomFloor;
+    while (config.floorCount > 1 && exitFloor == randomFloor) {
+        exitFloor = randomInt(RandomPassengerDestination, config.floorCount) + 1;
+    }
+
+    ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(passengerId),
+                     "> Passenger " + std::to_string(passengerId) + " requested car at floor "
+                     + std::to_string(randomFloor) + ".");
+    requestJourney(passengerId, randomFloor, exitFloor);
+}
+
+int SimulationEngine::randomInt(RandomSource source, int bound)
+{
+    return state.randomStreams[source].nextInt(bound);
+}
+
+int SimulationEngine::clampFloor(int floor) const
+{
+    return std::min(std::max(floor, 1), std::max(1, config.floorCount));
+}
+
+/**
+ * @brief Pairs a car request with the same passenger's first exit scheduled at or after it
+ * @return The exit floor, -1 if the passenger has no such exit
+ */
+int SimulationEngine::takePairedExitFloor(const PassengerAction &request)
+{
+    const int exitIndex = state.exitActions.take(*config.actions, request.passengerId, request.timeStep);
+    if (exitIndex < 0) {
+        return -1;
+    }
+
+    state.exitActionPaired[exitIndex] = true;
+    return config.actions->getFloors()[exitIndex];
+}
+
+/**
+ * @brief Creates a journey and lets the dispatcher assign it to a car
+ */
+void SimulationEngine::requestJourney(int passengerId, int origin, int destination)
+{
+    PassengerJourney journey;
+    journey.passengerId = passengerId;
+    journey.origin = origin;
+    journey.destination = destination;
+    journey.requestTimeStep = state.currentTimeStep;
+    {
+        PROFILE_SCOPE("Dispatcher::assign");
+        journey.car = dispatcher->assign(journey, state.cars);
+    }
+
+    int journeyIndex;
+    if (state.freeJourneySlots.empty()) {
+        journeyIndex = static_cast<int>(state.journeys.size());
+        state.journeys.push_back(journey);
+    } else {
+        journeyIndex = state.freeJourneySlots.back();
+        state.freeJourneySlots.pop_back();
+        state.journeys[journeyIndex] = journey;
+    }
+    ++state.metrics.journeysRequested;
+    state.passengers.request(passengerId, origin, destination, journey.car, state.currentTimeStep);
+
+    ElevatorCar &car = state.cars[journey.car];
+    car.waitingByFloor[origin].push_back(journeyIndex);
+    car.stops.insert(origin);
+    if (car.state == ElevatorCar::Moving) {
+        shortenTrip(car, origin);
+    }
+    ++car.passengersAssigned;
+
+    ENGINE_LOG_ABOUT(Movement, Info, SimulationLog::passenger(passengerId, car.id),
+                     "Elevator " + std::to_string(car.id) + " assigned to the call at floor "
+                     + std::to_string(origin) + " (destination floor " + std::to_string(destination) + ").");
+}
+
+/**
+ * @brief Advances every car that reached its stop or closed its doors: serve the current floor, or leave for the
+ *        first stop ahead while keeping the direction as long as stops remain ahead (LOOK). The whole trip is one
+ *        event whatever its length, it takes config.timing.floorTravelSteps per floor plus the acceleration time
+ *        when leaving and when arriving
+ */
+void SimulationEngine::moveCars()
+{
+    PROFILE_SCOPE("SimulationEngine::moveCars");
+
+    const CarTiming &timing = config.timing;
+    for (ElevatorCar &car : state.cars) {
+        if (car.readyTimeStep > state.currentTimeStep) {
+            continue;
+        }
+
+        if (car.state == ElevatorCar::Moving && movementSink &&
+            logFilter.isEnabled(SimulationLog::Movement, SimulationLog::Debug)) {
+            movementSink(car.trip);
+        }
+
+        if (car.stops.count(car.floor)) {
+            serveFloor(car);
+            car.readyTimeStep = state.currentTimeStep + timing.doorDwellSteps;
+            continue;
+        }
+
+        if (car.stops.empty()) {
+            if (car.state != ElevatorCar::Idle) {
+                car.state = ElevatorCar::Idle;
+                car.direction = ElevatorCar::None;
+                ENGINE_LOG_ABOUT(Movement, Info, SimulationLog::car(car.id), elevatorStatus(car));
+            }
+            continue;
+        }
+
+        const bool keepDirection = (car.direction == ElevatorCar::Up && car.hasStopAbove()) ||
+                                   (car.direction == ElevatorCar::Down && car.hasStopBelow());
+        if (!keepDirection) {
+            // Head for the closest stop
+            auto above = car.stops.upper_bound(car.floor);
+            bool goUp = above != car.stops.end();
+            if (goUp && car.hasStopBelow()) {
+                goUp = *above - car.floor <= car.floor - *std::prev(car.stops.lower_bound(car.floor));
+            }
+            car.direction = goUp ? ElevatorCar::Up : ElevatorCar::Down;
+        }
+
+        car.state = ElevatorCar::Moving;
+        ENGINE_LOG_ABOUT(Movement, Info, SimulationLog::car(car.id), elevatorStatus(car));
+
+        MovementSegment &trip = car.trip;
+        trip.carId = car.id;
+        trip.fromFloor = car.floor;
+        trip.toFloor = car.direction == ElevatorCar::Up ? *car.stops.upper_bound(car.floor)
+                                                        : *std::prev(car.stops.lower_bound(car.floor));
+        trip.startTimeStep = state.currentTimeStep;
+        trip.firstFloorTimeStep = state.currentTimeStep + timing.accelerationSteps + timing.floorTravelSteps;
+        trip.floorTravelSteps = timing.floorTravelSteps;
+        trip.endTimeStep = trip.firstFloorTimeStep + (trip.floorCount() - 1) * timing.floorTravelSteps
+                         + timing.accelerationSteps;
+        car.floor = trip.toFloor;
+        car.readyTimeStep = trip.endTimeStep;
+    }
+}
+
+/**
+ * @brief Ends the trip of a moving car at a new stop it has not passed yet. The car arrives when it would have
+ *        reached that floor, plus the time to slow down unless it is already on its way to it
+ * @param car The moving car
+ * @param stop The floor of the new stop
+ */
+void SimulationEngine::shortenTrip(ElevatorCar &car, int stop)
+{
+    MovementSegment &trip = car.trip;
+    const int floors = (stop - trip.fromFloor) * trip.direction();
+    const int headingTo = (trip.floorAt(state.currentTimeStep) - trip.fromFloor) * trip.direction();
+    if (floors < headingTo || floors >= trip.floorCount()) {
+        return;
+    }
+
+    trip.toFloor = stop;
+    trip.endTimeStep = trip.firstFloorTimeStep + (floors - 1) * trip.floorTravelSteps
+                     + (floors > headingTo ? config.timing.accelerationSteps : 0);
+    car.floor = stop;
+    car.readyTimeStep = trip.endTimeStep;
+}
+
+/**
+ * @brief Stops a car at its floor, lets its riders out then boards the passengers waiting for it
+ */
+void SimulationEngine::serveFloor(ElevatorCar &car)
+{
+    const int floor = car.floor;
+    car.state = ElevatorCar::Stopped;
+    car.stops.erase(floor);
+    ENGINE_LOG_ABOUT(Movement, Info, SimulationLog::car(car.id), elevatorStatus(car));
+
+    std::vector<int> exiting;
+    exiting.swap(car.ridingByFloor[floor]);
+
+    std::vector<int> boarding;
+    boarding.swap(car.waitingByFloor[floor]);
+    for (int journeyIndex : boarding) {
+        PassengerJourney &journey = state.journeys[journeyIndex];
+        journey.state = PassengerJourney::Riding;
+        journey.boardTimeStep = state.currentTimeStep;
+        state.metrics.totalWaitSteps += state.currentTimeStep - journey.requestTimeStep;
+        state.metrics.latency.recordWait(journey.origin, car.id, state.currentTimeStep - journey.requestTimeStep);
+        state.passengers.board(journey.passengerId, state.currentTimeStep);
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(journey.passengerId, car.id),
+                         "> Passenger " + std::to_string(journey.passengerId) + " has entered elevator "
+                         + std::to_string(car.id) + ".");
+
+        if (journey.destination == floor) {
+            exiting.push_back(journeyIndex);
+        } else {
+            car.ridingByFloor[journey.destination].push_back(journeyIndex);
+            car.stops.insert(journey.destination);
+        }
+    }
+
+    for (int journeyIndex : exiting) {
+        PassengerJourney &journey = state.journeys[journeyIndex];
+        journey.state = PassengerJourney::Done;
+        journey.exitTimeStep = state.currentTimeStep;
+        state.metrics.totalRideSteps += state.currentTimeStep - journey.boardTimeStep;
+        ++state.metrics.journeysCompleted;
+        state.metrics.latency.recordExit(journey.origin, car.id, state.currentTimeStep - journey.boardTimeStep,
+                                         state.currentTimeStep - journey.requestTimeStep);
+        state.passengers.exit(journey.passengerId, state.currentTimeStep);
+        --car.passengersAssigned;
+        completePassengers(1);
+        state.freeJourneySlots.push_back(journeyIndex);
+
+        ENGINE_LOG_ABOUT(Passenger, Info, SimulationLog::passenger(journey.passengerId, car.id),
+                         "> Passenger " + std::to_string(journey.passengerId) + " exited elevator "
+                         + std::to_string(car.id) + " at floor " + std::to_string(floor) + ".");
+        ENGINE_LOG(Passenger, Info, completedStatus(state.completedPassengers, config.passengerCount));
+    }
+}
+
+/**
+ * @brief Triggers the safety events scheduled for the current time step in list order, the calendar only
+ *        touches the events that are due
+ */
+void SimulationEngine::processSafetyEvents()
+{
+    PROFILE_SCOPE("SimulationEngine::processSafetyEvents");
+
+    closeSafetyDoors();
+
+    dueSafetyEvents.clear();
+    state.safetyCalendar.takeDue(state.currentTimeStep, dueSafetyEvents);
+    for (int index : dueSafetyEvents) {
+        triggerSafetyEvent(config.safetyEvents[index]);
+    }
+}
+
+/**
+ * @brief Displays a safety event, in each event >= 1 passengers is completed, allowing the simulation to reach its base case
+ * @param event The safety event
+ */
+void SimulationEngine::triggerSafetyEvent(const SafetyEvent &event)
+{
+    if (event.kind >= SafetyEvent::KindCount) {
+        return;
+    }
+
+    ENGINE_LOG(Safety, Info, "----------------");
+    (this->*safetyHandlers[event.kind])(event);
+
+    const int holdSteps = config.timing.safetyDoorHoldSteps;
+    ENGINE_LOG(Safety, Info, "Elevator doors open (" + std::to_string(holdSteps) + " seconds).");
+    state.safetyDoorsClosing.push_back(state.currentTimeStep + holdSteps);
+    closeSafetyDoors();
+    // Log the current progress
+    ENGINE_LOG(Passenger, Info, completedStatus(state.completedPassengers, config.passengerCount));
+}
+
+/**
+ * @brief Closes the doors whose safety event hold time is over, the hold time is the same for every event so
+ *        they close in the order they opened
+ */
+void SimulationEngine::closeSafetyDoors()
+{
+    std::vector<int> &closing = state.safetyDoorsClosing;
+    std::size_t closed = 0;
+    while (closed < closing.size() && closing[closed] <= state.currentTimeStep) {
+        ENGINE_LOG(Safety, Info, "Bell rings.");
+        ENGINE_LOG(Safety, Info, "Elevator doors closed.");
+        ++closed;
+    }
+    closing.erase(closing.begin(), closing.begin() + closed);
+}
+
+void SimulationEngine::handleHelp(const SafetyEvent &event)
+{
+    ENGINE_LOG_ABOUT(Safety, Warning, eventSubject(event), "Help Alarm Triggered" + eventTarget(event));
+    ENGINE_LOG(Safety, Info, "> Stay calm, connecting passenger to building safety services.");
+
+    // 50/50 chance that the building safety responds
+    if (randomInt(HelpOutcome, 2) == 0){
+        ENGINE_LOG(Safety, Info, "> Connected to building safety services. Please remain calm, help is on the way");
+    } else {
+        ENGINE_LOG(Safety, Info, "> Unable to contact building safety services, 911 emergency call has been placed.");
+    }
+    completePassengers(1);
+}
+
+void SimulationEngine::handleDoorObstacle(const SafetyEvent &event)
+{
+    ENGINE_LOG_ABOUT(Safety, Warning, eventSubject(event),
+                     "Door Obstacle Triggered by Light Sensors" + eventTarget(event));
+    ENGINE_LOG(Safety, Info, "Elevator doors remain open.");
+    ENGINE_LOG(Safety, Info, "> Please remove the obstacle blocking the door!");
+
+    // 50/50 chance that door obstacle is moved,
+    if (randomInt(DoorObstacleOutcome, 2) == 0){
+        ENGINE_LOG(Safety, Info, "> Obstacle has been moved.");
+    } else {
+        ENGINE_LOG(Safety, Info, "> Obstacle has not been moved.");
+        ENGINE_LOG(Safety, Info, "> Passengers are asked to disembark.");
+    }
+    completePassengers(1);
+}
+
+/**
+ * @brief Moves either the elevator, or all the elevators to their safe floors
+ */
+void SimulationEngine::handleFire(const SafetyEvent &event)
+{
+    if (state.metrics.evacuationStartTimeStep < 0) {
+        state.metrics.evacuationStartTimeStep = state.currentTimeStep;
+    }
+    ENGINE_LOG(Safety, Critical, "Fire Alarm Triggered" + eventTarget(event));
+    ENGINE_LOG(Safety, Info, "> Stay calm, moving the elevator(s) to a safe floor.");
+    // 50/50 chance that all elevators experience the fire signal
+    if (randomInt(FireOutcome, 2) == 0){
+        ENGINE_LOG(Safety, Info, "> All elevators have reached a safe floor, please exit!");
+        completePassengers(config.passengerCount);
+    } else {
+        ENGINE_LOG(Safety, Info, "Elevator has reached a safe floor, please exit");
+        completePassengers(1);
+    }
+}
+
+void SimulationEngine::handleOverload(const SafetyEvent &event)
+{
+    ENGINE_LOG_ABOUT(Safety, Warning, eventSubject(event), "Overload Alarm Triggered" + eventTarget(event));
+    ENGINE_LOG(Safety, Info, "> Please reduce the weight load before the elevator proceeds.");
+
+    // 50/50 chance that the load is moved
+    if (randomInt(OverloadOutcome, 2) == 0){
+        ENGINE_LOG(Safety, Info, "> Load has been moved, elevator will commence.");
+    } else {
+        ENGINE_LOG(Safety, Info, "Elevator is still overloaded.");
+        ENGINE_LOG(Safety, Info, "> Passengers are asked to disembark.");
+    }
+    completePassengers(1);
+}
+
+/**
+ * @brief All elevators reach their safe floors, and everyone exits, ending the simulation
+ */
+void SimulationEngine::handlePowerOut(const SafetyEvent &event)
+{
+    if (state.metrics.evacuationStartTimeStep < 0) {
+        state.metrics.evacuationStartTimeStep = state.currentTimeStep;
+    }
+    ENGINE_LOG(Safety, Critical, "Power Out Alarm Triggered" + eventTarget(event));
+    ENGINE_LOG(Safety, Info, "> Stay calm, moving the elevators to a safe floor.");
+    ENGINE_LOG(Safety, Info, "> All elevators have reached a safe floor, please exit!");
+    ENGINE_LOG(Safety, Info, "All passengers have exited the elevators.");
+    completePassengers(config.passengerCount);
+}
@@ -0,0 +1,173 @@
+#ifndef SIMULATIONENGINE_H
+#define SIMULATIONENGINE_H
+
+#include "SimulationConfig.h"
+#include "SimulationMetrics.h"
+#include "SimulationState.h"
+#include "SimulationLog.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The SimulationEngine class is responsible for:
+ *        - Running the elevator simulation as a discrete-event simulation, jumping from one time step with
+ *          something to process (an action, a safety event, a car reaching its next stop or closing its doors)
+ *          to the next
+ *        - Turning passengers' actions and randomized passengers into journeys
+ *        - Assigning the journeys to the cars of the elevator bank through the Dispatcher
+ *        - Moving the cars from stop to stop with the travel, acceleration and door dwell times of config.timing,
+ *          one event per trip, and boarding/exiting passengers
+ *        - Handling the safety events, scheduled in their own calendar and dispatched through a handler table
+ *        - Saving and restoring its whole run state (SimulationState), and keeping checkpoints of it to jump
+ *          to any time step of the run
+ *        It uses no widgets or timers, so it can be stepped as fast as the CPU allows
+ *        by the GUI (SimulationControls) or by the command line runner (elevator-sim-cli)
+ */
+class SimulationEngine
+{
+public:
+    // Receives every enabled line the simulation would display on the log console, with the car and the
+    // passenger it is about
+    typedef std::function<void(SimulationLog::Category, SimulationLog::Level, const std::string &,
+                               const SimulationLog::Subject &)> LogSink;
+    // Receives every trip of a car when it reaches its stop, in place of one Movement Debug line per floor: it is
+    // only called while those are enabled, a viewer expands the trip into the lines it displays
+    typedef std::function<void(const MovementSegment &)> MovementSink;
+
+    // The configuration is copied once and should pass SimulationConfig::validate(), only updateActions() changes it
+    explicit SimulationEngine(const SimulationConfig &config, LogSink logSink = LogSink());
+
+    // Messages outside the filter are never formatted, by default every category is enabled
+    void setLogFilter(const LogFilter &filter);
+    const LogFilter &getLogFilter() const { return logFilter; }
+
+    void setMovementSink(MovementSink sink) { movementSink = sink; }
+
+    // Resets the run state to time step 0
+    void start();
+
+    // Processes the current time step then advances to the next one something happens at, returns false once the
+    // simulation is complete
+    bool step();
+
+    // Steps until the simulation is complete or maxSteps time steps were simulated (-1 for no limit), returns the
+    // time steps simulated. The time stops at exactly maxSteps even when the next event is later
+    int run(int maxSteps = -1);
+
+    // Switches to a newer snapshot of the action list, allowed while the simulation is running.
+    // Snapshots only grow, so the actions past the current snapshot's end are the new ones
+    void updateActions(const PassengerActionSnapshot &snapshot);
+
+    bool isRunning() const { return state.simulationRunning; }
+    int getCurrentTimeStep() const { return state.currentTimeStep; }
+    int getCompletedPassengers() const { return state.completedPassengers; }
+    const std::vector<ElevatorCar> &getCars() const { return state.cars; }
+    // Journey slots, the slot of a finished journey (state Done) is reused by a later request, so the list
+    // grows with the passengers in the building at once rather than with the length of the run
+    const std::vector<PassengerJourney> &getJourneys() const { return state.journeys; }
+    // Every passenger by ID, unlike the journey slots rows are kept once the journey is done. Random passengers
+    // are numbered from firstRandomPassengerIdOf(config), and after any higher ID updateActions() brings
+    const PassengerTable &getPassengers() const { return state.passengers; }
+
+    // ID of the first random passenger of a run of config: after the passenger count and every passenger ID of
+    // config.actions and config.actionStream, so random passengers never share a row with a scripted one
+    static int firstRandomPassengerIdOf(const SimulationConfig &config);
+    const SimulationMetrics &getMetrics() const { return state.metrics; }
+    const SimulationConfig &getConfig() const { return config; }
+
+    // The run state at the current time step, a copy of it can be restored by this engine or any engine
+    // built from the same configuration
+    const SimulationState &getState() const { return state; }
+
+    // Continues from a state saved with the same configuration, the actions the state does not know yet are
+    // scheduled like updateActions() does. Returns false and keeps the current state if the state does not
+    // fit the configuration
+    bool restoreState(const SimulationState &state);
+
+    // Continues from a state saved by a run of an earlier version of the action list, the versions may only differ
+    // in actions due at or after the state's time step, in appended actions and in the ExitCar actions of
+    // editedExitPassengers, none of whose car requests the state processed. Used by IncrementalSimulation
+    bool restoreEditedState(const SimulationState &state, const std::vector<int> &editedExitPassengers);
+
+    // Keeps a copy of the state every steps time steps from now on (0 to keep none). At most maxCheckpoints
+    // are kept, when there are more every other one is dropped and the interval doubles
+    void setCheckpointInterval(int steps);
+    int getCheckpointInterval() const { return checkpointInterval; }
+    const std::map<int, SimulationState> &getCheckpoints() const { return checkpoints; }
+
+    // Moves the simulation to timeStep: restores the last checkpoint at or before it when going back (or when a
+    // later checkpoint than the current time step exists) and steps forward from there without logging.
+    // Returns false if the simulation completed before reaching timeStep
+    bool seek(int timeStep);
+
+    static const int maxCheckpoints = 64;
+
+private:
+    void processEventTimeStep(int limit);
+    int firstEventTimeStep(int timeStep) const;
+    void advanceTo(int timeStep);
+    void processSimulationStep();
+    void executePassengerAction(int actionIndex);
+    // matched: a RequestCar has the destination matchedFloor, an ExitCar belongs to a car request
+    void executePassengerAction(const PassengerAction &action, bool matched, int matchedFloor);
+    // Copies the streamed records of the current time step into dueRecords and releases the pages read past
+    void takeDueRecords();
+    void randomizePassengerBehaviour();
+    void processSafetyEvents();
+    // Displays the event and hands it to the handler of its kind, in each event >= 1 passengers is completed
+    void triggerSafetyEvent(const SafetyEvent &event);
+    void handleHelp(const SafetyEvent &event);
+    void handleDoorObstacle(const SafetyEvent &event);
+    void handleFire(const SafetyEvent &event);
+    void handleOverload(const SafetyEvent &event);
+    void handlePowerOut(const SafetyEvent &event);
+    typedef void (SimulationEngine::*SafetyHandler)(const SafetyEvent &event);
+    static const SafetyHandler safetyHandlers[SafetyEvent::KindCount];
+    void closeSafetyDoors();
+    bool isComplete() const;
+    // Adds to the completed passengers, at most up to the passenger count
+    void completePassengers(int count);
+    void logSimulationComplete();
+    void takeCheckpoint();
+    void scheduleUnknownActions();
+    bool fitsConfig(const SimulationState &state) const;
+
+    // Every source of randomness draws from its own substream of config.seed, so adding draws to one
+    // (e.g. a new safety event) never changes the values another one sees
+    enum RandomSource {
+        RandomPassengerOrigin,
+        RandomPassengerDestination,
+        HelpOutcome,
+        DoorObstacleOutcome,
+        FireOutcome,
+        OverloadOutcome,
+        RandomSourceCount
+    };
+    int randomInt(RandomSource source, int bound);
+
+    // Journeys and the elevator bank
+    int clampFloor(int floor) const;
+    int takePairedExitFloor(const PassengerAction &request);
+    void requestJourney(int passengerId, int origin, int destination);
+    void moveCars();
+    void shortenTrip(ElevatorCar &car, int stop);
+    void serveFloor(ElevatorCar &car);
+
+    SimulationConfig config;
+    LogSink logSink;
+    MovementSink movementSink;
+    LogFilter logFilter;
+    SimulationState state;
+    std::vector<int> dueActions;            // Indices of the actions due at the current time step
+    std::vector<int> dueSafetyEvents;       // Indices of the safety events due at the current time step
+    std::vector<ScenarioRecord> dueRecords; // Streamed records due at the current time step
+    std::unique_ptr<Dispatcher> dispatcher;
+
+    int checkpointInterval;                 // Time steps between two checkpoints, 0 keeps none
+    std::map<int, SimulationState> checkpoints;
+};
+
+#endif // SIMULATIONENGINE_H
@@ -0,0 +1,7 @@
+# Builds the simulation engine as a standalone static library (no Qt modules required)
+TEMPLATE = lib
+TARGET = SimulationEngine
+CONFIG += staticlib c++17
+CONFIG -= qt
+
+include(engine.pri)
@@ -0,0 +1,23 @@
+#include "SimulationLog.h"
+
+const char *SimulationLog::categoryName(Category category)
+{
+    switch (category) {
+    case Movement: return "movement";
+    case Passenger: return "passenger";
+    case Safety: return "safety";
+    case Lifecycle: return "lifecycle";
+    default: return "unknown";
+    }
+}
+
+const char *SimulationLog::levelName(Level level)
+{
+    switch (level) {
+    case Debug: return "debug";
+    case Info: return "info";
+    case Warning: return "warning";
+    case Critical: return "critical";
+    default: return "disabled";
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef SIMULATIONLOG_H
+#define SIMULATIONLOG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief The SimulationLog struct holds the log categories and severity levels shared by the engine and the log console
+ */
+struct SimulationLog {
+    enum Category : std::uint8_t {
+        Movement,   // Elevator position, state and per-floor travel
+        Passenger,  // Passenger requests, boarding, exits and completion
+        Safety,     // Safety alarms and how they're handled
+        Lifecycle,  // Simulation start, steps, completion
+        CategoryCount
+    };
+
+    enum Level : std::uint8_t {
+        Debug,
+        Info,
+        Warning,
+        Critical,
+        Disabled    // Minimum level that turns a category off
+    };
+
+    // The car and the passenger a message is about, -1 for none, so a viewer can index messages without
+    // reading their text
+    struct Subject {
+        int carId = -1;
+        int passengerId = -1;
+    };
+
+    static Subject car(int carId) {
+        Subject subject;
+        subject.carId = carId;
+        return subject;
+    }
+
+    // Passenger ID 0 is an action without a passenger
+    static Subject passenger(int passengerId, int carId = -1) {
+        Subject subject;
+        subject.carId = carId;
+        subject.passengerId = passengerId > 0 ? passengerId : -1;
+        return subject;
+    }
+
+    static const char *categoryName(Category category);
+    static const char *levelName(Level level);
+};
+
+/**
+ * @brief The LogFilter class is responsible for deciding which messages are formatted at all:
+ *        - One minimum level per category
+ *        - isEnabled() is a table lookup and a compare, so a disabled message costs about a branch
+ */
+class LogFilter
+{
+public:
+    // Every category enabled at minimumLevel
+    explicit LogFilter(SimulationLog::Level minimumLevel = SimulationLog::Debug) {
+        std::memset(minimumLevels, minimumLevel, sizeof(minimumLevels));
+    }
+
+    bool isEnabled(SimulationLog::Category category, SimulationLog::Level level) const {
+        return level >= minimumLevels[category];
+    }
+
+    void setMinimumLevel(SimulationLog::Category category, SimulationLog::Level level) {
+        minimumLevels[category] = level;
+    }
+
+    SimulationLog::Level getMinimumLevel(SimulationLog::Category category) const {
+        return static_cast<SimulationLog::Level>(minimumLevels[category]);
+    }
+
+    void setCategoryEnabled(SimulationLog::Category category, bool enabled) {
+        minimumLevels[category] = enabled ? SimulationLog::Debug : SimulationLog::Disabled;
+    }
+
+    // Also enables what other enables, the lower minimum level of each category
+    void enable(const LogFilter &other) {
+        for (int category = 0; category < SimulationLog::CategoryCount; ++category) {
+            minimumLevels[category] = std::min(minimumLevels[category], other.minimumLevels[category]);
+        }
+    }
+
+private:
+    std::uint8_t minimumLevels[SimulationLog::CategoryCount];
+};
+
+// Evaluates message (and its string formatting) only if the filter lets the category and level through
+#define SIM_LOG_IF(filter, category, level, sink, subject, message) \
+    do { \
+        if ((filter).isEnabled((category), (level))) { \
+            sink((category), (level), (message), (subject)); \
+        } \
+    } while (0)
+
+#endif // SIMULATIONLOG_H
@@ -0,0 +1,41 @@
+#ifndef SIMULATIONMETRICS_H
+#define SIMULATIONMETRICS_H
+
+#include "LatencyMetrics.h"
+
+/**
+ * @brief The SimulationMetrics struct sums up how well the elevator bank served the passengers:
+ *        - Throughput, completed journeys per simulated minute (one time step is one second)
+ *        - Average wait, from the hall call to boarding, in time steps
+ *        - Average ride, from boarding to the exit, in time steps
+ *        - Evacuation time, from the first fire or power out alarm to the end of the simulation
+ *        - The wait, ride and journey time distributions, for percentiles per floor and per car
+ */
+struct SimulationMetrics {
+    int journeysRequested = 0;
+    int journeysCompleted = 0;
+    long long totalWaitSteps = 0;
+    long long totalRideSteps = 0;
+    int timeSteps = 0;
+    int evacuationStartTimeStep = -1; // Time step of the first fire or power out alarm, -1 if none
+    LatencyMetrics latency;
+
+    double averageWait() const {
+        return journeysCompleted > 0 ? static_cast<double>(totalWaitSteps) / journeysCompleted : 0.0;
+    }
+
+    double averageRide() const {
+        return journeysCompleted > 0 ? static_cast<double>(totalRideSteps) / journeysCompleted : 0.0;
+    }
+
+    // Time steps from the alarm to the last processed time step, -1 without an alarm
+    int evacuationTime() const {
+        return evacuationStartTimeStep >= 0 ? timeSteps - evacuationStartTimeStep : -1;
+    }
+
+    double throughputPerMinute() const {
+        return timeSteps > 0 ? journeysCompleted * 60.0 / timeSteps : 0.0;
+    }
+};
+
+#endif // SIMULATIONMETRICS_H
@@ -0,0 +1,110 @@
+#include "SimulationState.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+// The trip is only read while the car is moving
+bool sameTrip(const MovementSegment &a, const MovementSegment &b)
+{
+    return a.fromFloor == b.fromFloor && a.toFloor == b.toFloor && a.startTimeStep == b.startTimeStep
+        && a.firstFloorTimeStep == b.firstFloorTimeStep && a.floorTravelSteps == b.floorTravelSteps
+        && a.endTimeStep == b.endTimeStep;
+}
+
+bool sameCar(const ElevatorCar &a, const ElevatorCar &b)
+{
+    return a.id == b.id && a.floor == b.floor && a.state == b.state && a.direction == b.direction
+        && a.passengersAssigned == b.passengersAssigned && a.readyTimeStep == b.readyTimeStep && a.stops == b.stops
+        && (a.state != ElevatorCar::Moving || sameTrip(a.trip, b.trip))
+        && a.waitingByFloor == b.waitingByFloor && a.ridingByFloor == b.ridingByFloor;
+}
+
+bool sameJourney(const PassengerJourney &a, const PassengerJourney &b)
+{
+    return a.passengerId == b.passengerId && a.origin == b.origin && a.destination == b.destination
+        && a.car == b.car && a.state == b.state && a.requestTimeStep == b.requestTimeStep
+        && a.boardTimeStep == b.boardTimeStep && a.exitTimeStep == b.exitTimeStep;
+}
+
+// Same actions still to hand out. The sequence numbers only order the heap, mid-run actions scheduled in
+// another order by the two runs are ruled out by comparing the heaps entry by entry
+bool sameCalendar(const EventCalendar &a, const EventCalendar &b)
+{
+    const std::vector<EventCalendar::Entry> &heapA = a.getScheduled();
+    const std::vector<EventCalendar::Entry> &heapB = b.getScheduled();
+    return a.getCursor() == b.getCursor() && heapA.size() == heapB.size()
+        && std::equal(heapA.begin(), heapA.end(), heapB.begin(),
+                      [](const EventCalendar::Entry &x, const EventCalendar::Entry &y) {
+        return x.timeStep == y.timeStep && x.actionIndex == y.actionIndex;
+    });
+}
+
+}
+
+/**
+ * @brief Compares everything the following time steps read, of the metrics only the requested journeys (random
+ *        passengers stop once every passenger requested a car) and the evacuation start. Actions known by only one of the states were
+ *        added past the end of the other's list and are already processed, so only the common flags are compared
+ */
+bool SimulationState::evolvesLike(const SimulationState &other) const
+{
+    if (simulationRunning != other.simulationRunning || currentTimeStep != other.currentTimeStep ||
+        completedPassengers != other.completedPassengers || randomPassengerBase != other.randomPassengerBase ||
+        streamCursor != other.streamCursor ||
+        metrics.journeysRequested != other.metrics.journeysRequested ||
+        metrics.evacuationStartTimeStep != other.metrics.evacuationStartTimeStep ||
+        !sameCalendar(calendar, other.calendar) ||
+        safetyCalendar.getCursor() != other.safetyCalendar.getCursor() ||
+        safetyDoorsClosing != other.safetyDoorsClosing) {
+        return false;
+    }
+
+    if (randomStreams.size() != other.randomStreams.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < randomStreams.size(); ++i) {
+        if (randomStreams[i].position() != other.randomStreams[i].position()) {
+            return false;
+        }
+    }
+
+    if (cars.size() != other.cars.size() || journeys.size() != other.journeys.size() ||
+        freeJourneySlots != other.freeJourneySlots) {
+        return false;
+    }
+    for (std::size_t i = 0; i < cars.size(); ++i) {
+        if (!sameCar(cars[i], other.cars[i])) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < journeys.size(); ++i) {
+        if (!sameJourney(journeys[i], other.journeys[i])) {
+            return false;
+        }
+    }
+
+    const std::size_t commonActions = std::min(knownActionCount(), other.knownActionCount());
+    return exitActions.sameRemaining(other.exitActions)
+        && std::equal(exitActionPaired.begin(), exitActionPaired.begin() + commonActions,
+                      other.exitActionPaired.begin());
+}
+
+/**
+ * @brief Files the passengers' ExitCar actions among the known actions again, in time step order
+ * @param actions The action list the state continues with
+ * @param passengerIds Passengers whose exits changed
+ */
+void SimulationState::reindexExits(const ActionTable &actions, const std::vector<int> &passengerIds)
+{
+    exitActions.reindex(actions, knownActionCount(), passengerIds);
+
+    const std::unordered_set<int> passengers(passengerIds.begin(), passengerIds.end());
+    const std::vector<std::int32_t> &ids = actions.getPassengerIds();
+    const std::size_t count = std::min(knownActionCount(), actions.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        if (passengers.count(ids[i])) {
+            exitActionPaired[i] = false;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef SIMULATIONSTATE_H
+#define SIMULATIONSTATE_H
+
+#include "ActionTable.h"
+#include "ElevatorCar.h"
+#include "EventCalendar.h"
+#include "ExitActionIndex.h"
+#include "PassengerJourney.h"
+#include "PassengerTable.h"
+#include "RandomStream.h"
+#include "SimulationMetrics.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The SimulationState struct holds everything a SimulationEngine changes while it runs:
+ *        - The time step, the completed passengers and whether the simulation is still running
+ *        - The calendar positions in the scheduled actions and safety events, and the cursor in the streamed
+ *          binary scenario
+ *        - The position of every random substream
+ *        - The elevator bank, the journeys, the passenger table and the metrics
+ *        - The doors held open by safety events
+ *        - The ExitCar actions not paired with a car request yet
+ *        Together with the engine's SimulationConfig it determines the rest of the run, so an engine that restores
+ *        a state continues exactly like the engine that saved it. The calendar and the exit index share their lists
+ *        between copies, a copy costs the cars, the journeys in progress and one int per passenger
+ */
+struct SimulationState {
+    bool simulationRunning = false;
+    int currentTimeStep = 0;
+    int completedPassengers = 0;
+    // Random passenger n (from 1) has ID randomPassengerBase + n, raised when an action update brings a
+    // passenger ID past it
+    int randomPassengerBase = 0;
+
+    EventCalendar calendar;                 // Actions not yet due
+    EventCalendar safetyCalendar;           // Safety events not yet triggered, indices into config.safetyEvents
+    std::vector<RandomStream> randomStreams;
+
+    std::uint64_t streamCursor = 0;         // Next record of config.actionStream
+    std::uint64_t streamReleased = 0;       // Records before this one were handed back to the OS
+
+    std::vector<ElevatorCar> cars;
+    std::vector<PassengerJourney> journeys;
+    std::vector<int> freeJourneySlots;
+    PassengerTable passengers;              // Latest journey and completion of every passenger with an ID
+    std::vector<int> safetyDoorsClosing;    // Time steps the doors held open by safety events close, ascending
+    SimulationMetrics metrics;
+
+    // ExitCar actions give the destination of the same passenger's RequestCar
+    ExitActionIndex exitActions;
+    // One flag per action of the snapshot the state was built from, so its size is the number of known actions
+    std::vector<bool> exitActionPaired;
+
+    std::size_t knownActionCount() const { return exitActionPaired.size(); }
+
+    // True if the rest of the run from this state and from other is the same, given the same configuration and
+    // the same actions from the current time step on. The metrics' wait and ride sums and the passenger table are
+    // not compared, the run only writes them
+    bool evolvesLike(const SimulationState &other) const;
+
+    // Rebuilds the exit index of the passengers from actions, for passengers none of whose car requests
+    // was processed yet (so none of their exits was paired or skipped)
+    void reindexExits(const ActionTable &actions, const std::vector<int> &passengerIds);
+};
+
+#endif // SIMULATIONSTATE_H
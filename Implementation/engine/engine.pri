@@ -0,0 +1,58 @@
+# Widget-free simulation engine, shared by the GUI, the command line runner and the engine library
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+# ReplicationRunner and LogFileWriter run on std::thread workers
+CONFIG += thread
+
+# DEFINES += ELEVATOR_SIM_WITH_ZLIB lets LogFileWriter gzip the rotated log files
+contains(DEFINES, ELEVATOR_SIM_WITH_ZLIB): LIBS += -lz
+
+SOURCES += \
+    $$PWD/ActionTable.cpp \
+    $$PWD/CheckpointFile.cpp \
+    $$PWD/Dispatcher.cpp \
+    $$PWD/EventCalendar.cpp \
+    $$PWD/ExitActionIndex.cpp \
+    $$PWD/IncrementalSimulation.cpp \
+    $$PWD/LatencyHistogram.cpp \
+    $$PWD/LatencyMetrics.cpp \
+    $$PWD/LogFileWriter.cpp \
+    $$PWD/MappedScenario.cpp \
+    $$PWD/PassengerAction.cpp \
+    $$PWD/PassengerTable.cpp \
+    $$PWD/Profiler.cpp \
+    $$PWD/ReplicationRunner.cpp \
+    $$PWD/SafetyEvent.cpp \
+    $$PWD/SimulationConfig.cpp \
+    $$PWD/ScenarioFile.cpp \
+    $$PWD/SimulationEngine.cpp \
+    $$PWD/SimulationState.cpp \
+    $$PWD/SimulationLog.cpp
+
+HEADERS += \
+    $$PWD/ActionTable.h \
+    $$PWD/CheckpointFile.h \
+    $$PWD/Dispatcher.h \
+    $$PWD/ElevatorCar.h \
+    $$PWD/EventCalendar.h \
+    $$PWD/ExitActionIndex.h \
+    $$PWD/IncrementalSimulation.h \
+    $$PWD/LatencyHistogram.h \
+    $$PWD/LatencyMetrics.h \
+    $$PWD/LogFileWriter.h \
+    $$PWD/MappedScenario.h \
+    $$PWD/MovementSegment.h \
+    $$PWD/PassengerAction.h \
+    $$PWD/PassengerJourney.h \
+    $$PWD/PassengerTable.h \
+    $$PWD/Profiler.h \
+    $$PWD/RandomStream.h \
+    $$PWD/ReplicationRunner.h \
+    $$PWD/SafetyEvent.h \
+    $$PWD/ScenarioFile.h \
+    $$PWD/SimulationConfig.h \
+    $$PWD/SimulationEngine.h \
+    $$PWD/SimulationMetrics.h \
+    $$PWD/SimulationState.h \
+    $$PWD/SimulationLog.h
@@ -1,13 +1,58 @@
 #include "mainwindow.h"
+#include "LogFileWriter.h"
+#include "Profiler.h"
 
 #include <QApplication>
 #include <QLocale>
 #include <QTranslator>
+#include <QtGlobal>
+#include <string>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    MainWindow w;
-    w.show();
-    return a.exec();
+
+    // ELEVATOR_SIM_PROFILE=FILE records the simulation and log console timings and writes them as a Chrome trace
+    // on exit
+    const QByteArray profilePath = qgetenv("ELEVATOR_SIM_PROFILE");
+    Profiler::setEnabled(!profilePath.isEmpty());
+
+    // ELEVATOR_SIM_LOG_FILE=FILE also writes the log to FILE, rotated every 64 MB. It keeps every line whatever the
+    // console shows, or the lines from ELEVATOR_SIM_LOG_FILE_LEVEL=LEVEL (debug, info, warning, critical) on
+    std::string error;
+    LogFileWriter logFile;
+    const QByteArray logFilePath = qgetenv("ELEVATOR_SIM_LOG_FILE");
+    LogFilter logFileFilter;
+    const QByteArray logFileLevel = qgetenv("ELEVATOR_SIM_LOG_FILE_LEVEL");
+    for (int level = SimulationLog::Debug; level <= SimulationLog::Critical; ++level) {
+        if (logFileLevel == SimulationLog::levelName(static_cast<SimulationLog::Level>(level))) {
+            logFileFilter = LogFilter(static_cast<SimulationLog::Level>(level));
+        }
+    }
+    if (!logFilePath.isEmpty()) {
+        LogFileWriter::Options options;
+        options.path = logFilePath.toStdString();
+        if (!logFile.open(options, error)) {
+            qWarning("Log file error: %s", error.c_str());
+        }
+    }
+
+    int status = 0;
+    {
+        // Destroyed first, which stops the simulation thread and the log console before the log file is closed
+        MainWindow w;
+        if (logFile.isOpen()) {
+            w.setLogFile(&logFile, logFileFilter);
+        }
+        w.show();
+        status = a.exec();
+    }
+
+    if (!logFile.close(error)) {
+        qWarning("Log file error: %s", error.c_str());
+    }
+    if (!profilePath.isEmpty() && !Profiler::saveChromeTrace(profilePath.toStdString(), error)) {
+        qWarning("Profile error: %s", error.c_str());
+    }
+    return status;
 }
@@ -1,5 +1,6 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include <QStatusBar>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -8,7 +9,23 @@ MainWindow::MainWindow(QWidget *parent)
     ui->setupUi(this);
 
     // Setting up everything
-    logConsole = new LogConsole(ui->logConsoleOutput, this);
+    logConsole = new LogConsole(
+        ui->logConsoleOutput,
+        ui->logCategoryFilter,
+        ui->logCarFilter,
+        ui->logPassengerFilter,
+        this
+    );
+
+    logFilterSetup = new LogFilterSetup(
+        ui->logLevelInput,
+        ui->logMovementCheck,
+        ui->logPassengerCheck,
+        ui->logSafetyCheck,
+        ui->logLifecycleCheck,
+        logConsole,
+        this
+    );
 
     buildingSetup = new BuildingSetup(
         ui->passNumInput,
@@ -58,7 +75,10 @@ MainWindow::MainWindow(QWidget *parent)
                 ui->startBtn,
                 ui->stopBtn,
                 ui->pauseBtn,
+                ui->loadScenarioBtn,
+                ui->saveScenarioBtn,
                 ui->simTimeOutput,
+                ui->timeScaleInput,
                 logConsole,
                 buildingSetup,
                 safetyEventSetup,
@@ -66,7 +86,12 @@ MainWindow::MainWindow(QWidget *parent)
                 this
     );
 
-    ui->logConsoleOutput->setReadOnly(true);
+    // Reports the size and cost of each batched log flush
+    connect(logConsole, &LogConsole::flushed, this, [this](int lineCount, qint64 durationNs) {
+        statusBar()->showMessage(QString("Log flush: %1 lines in %2 ms")
+                                 .arg(lineCount)
+                                 .arg(durationNs / 1000000.0, 0, 'f', 2));
+    });
 }
 
 MainWindow::~MainWindow()
@@ -7,6 +7,7 @@
 #include "BuildingSetup.h"
 #include "PassengerBehaviourSetup.h"
 #include "SafetyEventSetup.h"
+#include "LogFilterSetup.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -20,9 +21,14 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Also writes the log lines fileFilter lets through to logFile, shown in the console or not. logFile must
+    // outlive the window
+    void setLogFile(LogFileWriter *logFile, const LogFilter &fileFilter) { logConsole->setLogFile(logFile, fileFilter); }
+
 private:
     Ui::MainWindow *ui;
     LogConsole *logConsole;
+    LogFilterSetup *logFilterSetup;
     BuildingSetup *buildingSetup;
     SimulationControls *simulationControls;
     PassengerBehaviourSetup *passengerBehaviourSetup;